@@ -1,10 +1,18 @@
 #!/usr/bin/env python3
-"""Convert HPT logo to RGB565 format for boot screen"""
+"""Convert HPT logo to RGB565 format for boot screen
+
+--jpeg writes a baseline JPEG (data/boot_splash.jpg) instead; embed it with
+embed_boot_splash.py data/boot_splash.jpg and the firmware decodes it with
+the ROM TJpgDec.
+"""
 
 from PIL import Image, ImageDraw, ImageFont
+import argparse
 import struct
 import os
 
+from frame_asset import encode_jpeg, DEFAULT_JPEG_QUALITY
+
 def rgb888_to_rgb565(r, g, b):
     """Convert RGB888 to RGB565 format with byte swap and invert"""
     # First convert to RGB565
@@ -21,7 +29,7 @@ def rgb888_to_rgb565(r, g, b):
     
     return inverted
 
-def convert_logo(input_path, output_path, bg_color=(0, 0, 0)):
+def convert_logo(input_path, output_path, bg_color=(0, 0, 0), jpeg_quality=None):
     """Convert PNG with transparency to RGB565 raw format with full screen splash"""
     print(f"Converting {input_path}...")
     
@@ -64,20 +72,31 @@ def convert_logo(input_path, output_path, bg_color=(0, 0, 0)):
     
     draw.text((text_x, text_y), text, fill=(255, 255, 255), font=font)
     
-    # Convert to RGB565
-    with open(output_path, 'wb') as f:
-        pixels = full_img.load()
-        for y in range(240):
-            for x in range(320):
-                r, g, b = pixels[x, y]
-                rgb565 = rgb888_to_rgb565(r, g, b)
-                f.write(struct.pack('<H', rgb565))
+    if jpeg_quality is not None:
+        with open(output_path, 'wb') as f:
+            f.write(encode_jpeg(full_img, jpeg_quality))
+    else:
+        # Convert to RGB565
+        with open(output_path, 'wb') as f:
+            pixels = full_img.load()
+            for y in range(240):
+                for x in range(320):
+                    r, g, b = pixels[x, y]
+                    rgb565 = rgb888_to_rgb565(r, g, b)
+                    f.write(struct.pack('<H', rgb565))
     
     file_size = os.path.getsize(output_path)
     print(f"  Created {output_path} ({file_size} bytes)")
     print(f"  Full screen: 320x240 with centered logo and text")
 
+parser = argparse.ArgumentParser(description="Convert the HPT logo into the boot splash")
+parser.add_argument('--jpeg', action='store_true', help="write baseline JPEG (boot_splash.jpg)")
+parser.add_argument('--quality', type=int, default=DEFAULT_JPEG_QUALITY, help="JPEG quality (default: 85)")
+args = parser.parse_args()
+
 # Convert HPT logo with black background
-convert_logo("src/ncat/HPT.png", "data/boot_splash.raw", bg_color=(0, 0, 0))
+output = "data/boot_splash.jpg" if args.jpeg else "data/boot_splash.raw"
+convert_logo("src/ncat/HPT.png", output, bg_color=(0, 0, 0),
+             jpeg_quality=args.quality if args.jpeg else None)
 
-print("\n✓ Logo converted! Copy boot_splash.raw to SD card.")
+print(f"\n✓ Logo converted! Embed {output} with embed_boot_splash.py.")
@@ -1,52 +1,110 @@
 #!/usr/bin/env python3
-"""Convert nyan cat frames to RGB565 format"""
+"""Convert nyan cat frames to RGB565 format
+
+Output formats (--format):
+  raw     Headerless RGB565 (legacy, 153,600 bytes per frame)
+  rgb565  NYF1 header + RGB565
+  index8  NYF1 header + 256-entry palette + 8 bpp indices
+  index4  NYF1 header + 16-entry palette + 4 bpp indices
+  auto    Smallest indexed format that holds every color (default)
+  jpeg    Baseline JPEG (nyan_N.jpg), decoded by the ROM TJpgDec
+
+Compression (--codec, NYF1 formats only):
+  none    Stored
+  rle     Run-length coded, one block per band
+  lz4     LZ4 block format, one block per band
+  auto    Smallest of the above, picked per frame (default)
+
+NYF1 headers record each frame's display time, parsed from the source file
+name (frame_NN_delay-0.1s.png -> 100 ms), for the firmware frame scheduler.
+
+All palette entries and pixels have the Swap+Invert transformation
+pre-applied, so the firmware can send them to the panel untouched.
+See lib/FRAME/frame_format.h for the header layout.
+"""
 
 from PIL import Image
+import argparse
 import struct
+import glob
+import re
 import os
 
-def rgb888_to_rgb565(r, g, b):
-    """Convert RGB888 to RGB565 format"""
-    r5 = (r >> 3) & 0x1F
-    g6 = (g >> 2) & 0x3F
-    b5 = (b >> 3) & 0x1F
-    return (r5 << 11) | (g6 << 5) | b5
+from frame_asset import panel_color, encode_frame, encode_jpeg, DEFAULT_BAND_LINES, DEFAULT_JPEG_QUALITY
 
-def convert_image(input_path, output_path):
-    """Convert PNG to RGB565 raw format with Swap+Invert transformation pre-applied"""
+def frame_delay_ms(path):
+    """Frame delay from an ezgif-style name (..._delay-0.1s.png), 0 if absent"""
+    match = re.search(r'delay-([0-9.]+)s', os.path.basename(path))
+    return int(round(float(match.group(1)) * 1000)) if match else 0
+
+def convert_image(input_path, output_path, fmt='auto', codec='auto', band_lines=DEFAULT_BAND_LINES,
+                  quality=DEFAULT_JPEG_QUALITY):
+    """Convert PNG to a frame asset with Swap+Invert transformation pre-applied"""
     print(f"Converting {os.path.basename(input_path)}...")
-    
+
     img = Image.open(input_path)
     img = img.convert('RGB')
     width, height = img.size
-    
+
+    if fmt == 'jpeg':
+        data = encode_jpeg(img, quality)
+        with open(output_path, 'wb') as f:
+            f.write(data)
+        print(f"  Created {os.path.basename(output_path)} ({len(data)} bytes, jpeg q{quality}, "
+              f"{width * height * 2 / len(data):.1f}x smaller than raw)")
+        return len(data)
+
+    pixels = img.load()
+    colors = [panel_color(*pixels[x, y]) for y in range(height) for x in range(width)]
+
     with open(output_path, 'wb') as f:
-        pixels = img.load()
-        for y in range(height):
-            for x in range(width):
-                r, g, b = pixels[x, y]
-                rgb565 = rgb888_to_rgb565(r, g, b)
-                
-                # Apply Swap+Invert transformation
-                swapped = (rgb565 >> 8) | ((rgb565 & 0xFF) << 8)  # Byte swap
-                inverted = ~swapped & 0xFFFF  # Invert
-                
-                f.write(struct.pack('<H', inverted))
-    
+        if fmt == 'raw':
+            for c in colors:
+                f.write(struct.pack('<H', c))
+            desc = 'raw'
+        else:
+            duration = frame_delay_ms(input_path)
+            data, chosen_fmt, chosen_codec = encode_frame(colors, width, height, fmt, codec,
+                                                          band_lines, duration)
+            f.write(data)
+            desc = f"{chosen_fmt}/{chosen_codec}, {duration} ms"
+
     file_size = os.path.getsize(output_path)
-    print(f"  Created {os.path.basename(output_path)} ({file_size} bytes, pre-transformed)")
-
-# Convert all 12 frames
-input_dir = "src/ncat/full frame"
-output_dir = "data"
-
-for i in range(12):
-    input_file = os.path.join(input_dir, f"frame_{i:02d}_delay-0.1s.png")
-    output_file = os.path.join(output_dir, f"nyan_{i}.raw")
-    
-    if os.path.exists(input_file):
-        convert_image(input_file, output_file)
-    else:
-        print(f"Warning: {input_file} not found")
-
-print(f"\n✓ Conversion complete! Copy .raw files to SD card.")
+    raw_size = width * height * 2
+    print(f"  Created {os.path.basename(output_path)} ({file_size} bytes, {desc}, "
+          f"{raw_size / file_size:.1f}x smaller than raw)")
+    return file_size
+
+def main():
+    parser = argparse.ArgumentParser(description="Convert Nyan Cat frames for the SD card")
+    parser.add_argument('--format', choices=['auto', 'raw', 'rgb565', 'index8', 'index4', 'jpeg'],
+                        default='auto', help="output pixel format (default: auto)")
+    parser.add_argument('--codec', choices=['auto', 'none', 'rle', 'lz4'],
+                        default='auto', help="band compression (default: auto)")
+    parser.add_argument('--band-lines', type=int, default=DEFAULT_BAND_LINES,
+                        help="lines per compressed band, must match CHUNK_LINES (default: 40)")
+    parser.add_argument('--quality', type=int, default=DEFAULT_JPEG_QUALITY,
+                        help="JPEG quality for --format jpeg (default: 85)")
+    parser.add_argument('--input', default="src/ncat/full frame", help="source frame directory")
+    parser.add_argument('--output', default="data", help="output directory")
+    args = parser.parse_args()
+
+    os.makedirs(args.output, exist_ok=True)
+
+    # Convert all 12 frames
+    total = 0
+    for i in range(12):
+        matches = sorted(glob.glob(os.path.join(args.input, f"frame_{i:02d}_delay-*.png")))
+        ext = 'jpg' if args.format == 'jpeg' else 'raw'
+        output_file = os.path.join(args.output, f"nyan_{i}.{ext}")
+
+        if matches:
+            total += convert_image(matches[0], output_file, args.format, args.codec, args.band_lines,
+                                   args.quality)
+        else:
+            print(f"Warning: frame_{i:02d}_delay-*.png not found in {args.input}")
+
+    print(f"\n✓ Conversion complete! {total} bytes total. Copy .{ext} files to SD card.")
+
+if __name__ == "__main__":
+    main()
@@ -1,27 +1,51 @@
 #!/usr/bin/env python3
-"""Embed boot_splash.raw into firmware as C array"""
+"""Pack boot_splash.raw (or a baseline boot_splash.jpg) into src/boot_splash.bin
 
+The build embeds src/boot_splash.bin as a binary blob (EMBED_FILES in
+src/CMakeLists.txt). A raw RGB565 splash is stored as a compressed NYF1
+asset (palette + RLE/LZ4 bands, see frame_asset.py) that show_boot_screen()
+decodes band by band; a JPEG is stored as-is and decoded by the ROM TJpgDec.
+The firmware tells the two apart by the JPEG start-of-image marker.
+"""
+
+import argparse
 import os
+import struct
+
+from frame_asset import encode_frame, DEFAULT_BAND_LINES
 
-def embed_file_as_array(input_path, output_path, array_name):
-    """Convert binary file to C array"""
+OUTPUT = 'src/boot_splash.bin'
+SPLASH_WIDTH = 320
+SPLASH_HEIGHT = 240
+
+def pack_splash(input_path, output_path, codec='auto'):
+    """Write the splash blob; returns (size, description)"""
     with open(input_path, 'rb') as f:
         data = f.read()
-    
-    with open(output_path, 'w') as f:
-        f.write(f'// Auto-generated from {input_path}\n')
-        f.write(f'// File size: {len(data)} bytes\n\n')
-        f.write(f'#include <stdint.h>\n\n')
-        f.write(f'const uint32_t {array_name}_size = {len(data)};\n')
-        f.write(f'const uint8_t {array_name}[] = {{\n')
-        
-        for i in range(0, len(data), 16):
-            chunk = data[i:i+16]
-            hex_values = ', '.join(f'0x{b:02x}' for b in chunk)
-            f.write(f'    {hex_values},\n')
-        
-        f.write('};\n')
-    
-    print(f"Embedded {len(data)} bytes into {output_path}")
-
-embed_file_as_array('data/boot_splash.raw', 'src/boot_splash_data.c', 'boot_splash_data')
+
+    if data[:2] == b'\xff\xd8':
+        blob, desc = data, 'jpeg'
+    else:
+        pixels = SPLASH_WIDTH * SPLASH_HEIGHT
+        if len(data) != pixels * 2:
+            raise ValueError(f"{input_path}: expected {pixels * 2} bytes of RGB565, got {len(data)}")
+        # Raw splash is already panel-ready (Swap+Invert applied by convert_boot_logo.py)
+        colors = list(struct.unpack(f'<{pixels}H', data))
+        blob, fmt, chosen = encode_frame(colors, SPLASH_WIDTH, SPLASH_HEIGHT, 'auto', codec,
+                                         DEFAULT_BAND_LINES)
+        desc = f'{fmt}/{chosen}'
+
+    with open(output_path, 'wb') as f:
+        f.write(blob)
+    return len(blob), len(data), desc
+
+parser = argparse.ArgumentParser(description="Pack the boot splash for embedding into firmware")
+parser.add_argument('input', nargs='?', default='data/boot_splash.raw',
+                    help="boot_splash.raw or boot_splash.jpg (default: data/boot_splash.raw)")
+parser.add_argument('--codec', choices=['auto', 'none', 'rle', 'lz4'], default='auto',
+                    help="Band codec for a raw splash (default: smallest)")
+args = parser.parse_args()
+
+size, source_size, desc = pack_splash(args.input, OUTPUT, args.codec)
+print(f"Packed {os.path.basename(args.input)} ({source_size} bytes) into {OUTPUT} "
+      f"({size} bytes, {desc})")
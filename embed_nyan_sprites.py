@@ -0,0 +1,85 @@
+#!/usr/bin/env python3
+"""Embed the cat-only Nyan sprites into firmware as 4 bpp C arrays
+
+Reads src/ncat/cat only frame/frame_*.gif and writes src/nyan_sprite_data.c
+for the procedural screensaver compositor (lib/NYAN). Palette index 0 is
+transparent; the remaining entries are panel-ready (Swap+Invert) RGB565.
+"""
+
+from PIL import Image
+import os
+
+from frame_asset import panel_color
+
+SPRITE_DIR = "src/ncat/cat only frame"
+OUTPUT = "src/nyan_sprite_data.c"
+FRAME_COUNT = 6
+
+def load_frames():
+    frames = []
+    for i in range(FRAME_COUNT):
+        img = Image.open(os.path.join(SPRITE_DIR, f"frame_{i}.gif")).convert('RGBA')
+        frames.append(img)
+    return frames
+
+def main():
+    frames = load_frames()
+    width, height = frames[0].size
+    if width % 2:
+        raise ValueError("Sprite width must be even for 4 bpp packing")
+
+    # Shared palette across all frames, index 0 reserved for transparency
+    colors = set()
+    for img in frames:
+        px = img.load()
+        for y in range(height):
+            for x in range(width):
+                r, g, b, a = px[x, y]
+                if a >= 128:
+                    colors.add(panel_color(r, g, b))
+    palette = sorted(colors)
+    if len(palette) > 15:
+        raise ValueError(f"{len(palette)} colors do not fit a 4 bpp palette")
+    index = {c: i + 1 for i, c in enumerate(palette)}
+
+    packed_frames = []
+    for img in frames:
+        px = img.load()
+        data = bytearray()
+        for y in range(height):
+            for x in range(0, width, 2):
+                pair = []
+                for xx in (x, x + 1):
+                    r, g, b, a = px[xx, y]
+                    pair.append(index[panel_color(r, g, b)] if a >= 128 else 0)
+                data.append((pair[0] << 4) | pair[1])
+        packed_frames.append(bytes(data))
+
+    frame_bytes = len(packed_frames[0])
+    duration_ms = frames[0].info.get('duration', 100)  # GIF frame delay
+    with open(OUTPUT, 'w') as f:
+        f.write(f'// Auto-generated from {SPRITE_DIR}/frame_*.gif by embed_nyan_sprites.py\n')
+        f.write(f'// {FRAME_COUNT} frames, {width}x{height}, 4 bpp, index 0 = transparent\n\n')
+        f.write('#include <stdint.h>\n\n')
+        f.write(f'const uint16_t nyan_sprite_width = {width};\n')
+        f.write(f'const uint16_t nyan_sprite_height = {height};\n')
+        f.write(f'const uint8_t nyan_sprite_frame_count = {FRAME_COUNT};\n')
+        f.write(f'const uint16_t nyan_sprite_duration_ms = {duration_ms};\n\n')
+        f.write('const uint16_t nyan_sprite_palette[16] = {\n')
+        entries = [0x0000] + palette + [0x0000] * (15 - len(palette))
+        f.write('    ' + ', '.join(f'0x{c:04x}' for c in entries) + '\n')
+        f.write('};\n\n')
+        f.write(f'const uint32_t nyan_sprite_frame_bytes = {frame_bytes};\n')
+        f.write(f'const uint8_t nyan_sprite_data[] = {{\n')
+        for n, data in enumerate(packed_frames):
+            f.write(f'    // Frame {n}\n')
+            for i in range(0, len(data), 16):
+                chunk = data[i:i + 16]
+                f.write('    ' + ', '.join(f'0x{b:02x}' for b in chunk) + ',\n')
+        f.write('};\n')
+
+    print(f"Embedded {FRAME_COUNT} sprites ({width}x{height}, {len(palette)} colors, "
+          f"{FRAME_COUNT * frame_bytes} bytes) into {OUTPUT}")
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,212 @@
+#!/usr/bin/env python3
+"""NYF1 frame asset encoder shared by the image conversion scripts
+
+Mirrors lib/FRAME/frame_format.h and lib/FRAME/frame_codec.c:
+  - Swap+Invert RGB565 panel colors
+  - RGB565 / 8 bpp / 4 bpp pixel encodings with a 16-bit palette
+  - RLE and LZ4 block compression in independent bands
+  - Baseline JPEG for the ROM TJpgDec path (lib/FRAME/frame_jpeg.c)
+"""
+
+import io
+import struct
+
+FRAME_MAGIC = b'NYF1'
+
+FMT_RGB565 = 0
+FMT_INDEX8 = 1
+FMT_INDEX4 = 2
+FORMAT_IDS = {'rgb565': FMT_RGB565, 'index8': FMT_INDEX8, 'index4': FMT_INDEX4}
+
+CODEC_NONE = 0
+CODEC_RLE = 1
+CODEC_LZ4 = 2
+CODEC_IDS = {'none': CODEC_NONE, 'rle': CODEC_RLE, 'lz4': CODEC_LZ4}
+
+DEFAULT_BAND_LINES = 40  # Matches CHUNK_LINES in src/main.c
+DEFAULT_JPEG_QUALITY = 85
+
+def rgb888_to_rgb565(r, g, b):
+    """Convert RGB888 to RGB565 format"""
+    r5 = (r >> 3) & 0x1F
+    g6 = (g >> 2) & 0x3F
+    b5 = (b >> 3) & 0x1F
+    return (r5 << 11) | (g6 << 5) | b5
+
+def panel_color(r, g, b):
+    """RGB888 to RGB565 with Swap+Invert transformation applied"""
+    rgb565 = rgb888_to_rgb565(r, g, b)
+    swapped = (rgb565 >> 8) | ((rgb565 & 0xFF) << 8)  # Byte swap
+    return ~swapped & 0xFFFF  # Invert
+
+def frame_header(width, height, fmt, codec, palette_size, band_lines, duration_ms=0):
+    """16-byte NYF1 header (little-endian)"""
+    return struct.pack('<4sHHBBHHH', FRAME_MAGIC, width, height, fmt, codec,
+                       palette_size, band_lines, duration_ms)
+
+def pick_format(requested, color_count):
+    if requested != 'auto':
+        return requested
+    if color_count <= 16:
+        return 'index4'
+    if color_count <= 256:
+        return 'index8'
+    return 'rgb565'
+
+def encode_pixels(colors, width, fmt):
+    """Encode panel colors as (palette, pixel bytes) for the given format"""
+    if fmt == 'rgb565':
+        return [], b''.join(struct.pack('<H', c) for c in colors)
+
+    palette = sorted(set(colors))
+    limit = 16 if fmt == 'index4' else 256
+    if len(palette) > limit:
+        raise ValueError(f"{len(palette)} colors do not fit {fmt} (max {limit})")
+    index = {c: i for i, c in enumerate(palette)}
+
+    if fmt == 'index8':
+        return palette, bytes(index[c] for c in colors)
+
+    # index4: two pixels per byte, left pixel in the high nibble
+    if width % 2:
+        raise ValueError("index4 requires an even frame width")
+    out = bytearray()
+    for i in range(0, len(colors), 2):
+        out.append((index[colors[i]] << 4) | index[colors[i + 1]])
+    return palette, bytes(out)
+
+def rle_compress(data, elem_size):
+    """RLE: ctrl bit7 = run of (ctrl&0x7F)+1 elements, else ctrl+1 literals"""
+    elems = [data[i:i + elem_size] for i in range(0, len(data), elem_size)]
+    out = bytearray()
+    literals = []
+
+    def flush_literals():
+        while literals:
+            chunk = literals[:128]
+            del literals[:128]
+            out.append(len(chunk) - 1)
+            for e in chunk:
+                out.extend(e)
+
+    i = 0
+    while i < len(elems):
+        run = 1
+        while i + run < len(elems) and run < 128 and elems[i + run] == elems[i]:
+            run += 1
+        if run >= 2:
+            flush_literals()
+            out.append(0x80 | (run - 1))
+            out += elems[i]
+            i += run
+        else:
+            literals.append(elems[i])
+            i += 1
+    flush_literals()
+    return bytes(out)
+
+def _lz4_length(out, n):
+    """LZ4 extended length bytes (after the 15 in the token nibble)"""
+    while n >= 255:
+        out.append(255)
+        n -= 255
+    out.append(n)
+
+def lz4_compress(data):
+    """Greedy LZ4 block compressor (hash of 4-byte sequences, 64 KB window)"""
+    MIN_MATCH = 4
+    LAST_LITERALS = 5    # Block must end with at least 5 literals
+    MF_LIMIT = 12        # Last match must start 12 bytes before the end
+    n = len(data)
+    out = bytearray()
+    table = {}
+    anchor = 0
+    i = 0
+
+    while i + MF_LIMIT < n:
+        key = data[i:i + MIN_MATCH]
+        cand = table.get(key)
+        table[key] = i
+        if cand is None or i - cand > 0xFFFF:
+            i += 1
+            continue
+
+        # Extend match forward, keeping the last literals reserved
+        limit = n - LAST_LITERALS
+        length = MIN_MATCH
+        while i + length < limit and data[cand + length] == data[i + length]:
+            length += 1
+
+        lit = i - anchor
+        ml = length - MIN_MATCH
+        token = (min(lit, 15) << 4) | min(ml, 15)
+        out.append(token)
+        if lit >= 15:
+            _lz4_length(out, lit - 15)
+        out += data[anchor:i]
+        out += struct.pack('<H', i - cand)
+        if ml >= 15:
+            _lz4_length(out, ml - 15)
+
+        # Index a few positions inside the match for better ratios
+        for j in range(i + 1, min(i + length, n - MIN_MATCH), 4):
+            table[data[j:j + MIN_MATCH]] = j
+        i += length
+        anchor = i
+
+    lit = n - anchor
+    out.append(min(lit, 15) << 4)
+    if lit >= 15:
+        _lz4_length(out, lit - 15)
+    out += data[anchor:]
+    return bytes(out)
+
+def compress_bands(data, line_bytes, height, band_lines, codec, elem_size):
+    """Split encoded pixel data into bands and compress each independently"""
+    out = bytearray()
+    band_bytes = line_bytes * band_lines
+    for y in range(0, height, band_lines):
+        start = y * line_bytes
+        band = data[start:start + band_bytes]
+        packed = rle_compress(band, elem_size) if codec == 'rle' else lz4_compress(band)
+        out += struct.pack('<I', len(packed))
+        out += packed
+    return bytes(out)
+
+def encode_frame(colors, width, height, fmt='auto', codec='none', band_lines=DEFAULT_BAND_LINES,
+                 duration_ms=0):
+    """Build a complete NYF1 asset; returns (bytes, format, codec)"""
+    fmt = pick_format(fmt, len(set(colors)))
+    palette, data = encode_pixels(colors, width, fmt)
+    line_bytes = len(data) // height
+    elem_size = 2 if fmt == 'rgb565' else 1
+
+    candidates = {'none': data}
+    codecs = ['rle', 'lz4'] if codec == 'auto' else ([codec] if codec != 'none' else [])
+    for c in codecs:
+        candidates[c] = compress_bands(data, line_bytes, height, band_lines, c, elem_size)
+    if codec != 'auto' and codec != 'none':
+        del candidates['none']
+
+    # Smallest payload wins (ties keep the cheaper codec: none < rle < lz4)
+    chosen = min(candidates, key=lambda c: (len(candidates[c]), CODEC_IDS[c]))
+    payload = candidates[chosen]
+
+    out = bytearray(frame_header(width, height, FORMAT_IDS[fmt], CODEC_IDS[chosen],
+                                 len(palette), band_lines if chosen != 'none' else 0,
+                                 duration_ms))
+    for c in palette:
+        out += struct.pack('<H', c)
+    out += payload
+    return bytes(out), fmt, chosen
+
+def encode_jpeg(img, quality=DEFAULT_JPEG_QUALITY):
+    """Baseline JPEG (4:2:0, no progressive scans) that the ROM TJpgDec accepts
+
+    The panel Swap+Invert is applied by the decoder, so the image is stored
+    with its natural colors.
+    """
+    buf = io.BytesIO()
+    img.convert('RGB').save(buf, format='JPEG', quality=quality, progressive=False,
+                            optimize=True, subsampling=2)
+    return buf.getvalue()
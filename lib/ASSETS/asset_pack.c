@@ -0,0 +1,165 @@
+#include "asset_pack.h"
+#include <string.h>
+#include "esp_log.h"
+#ifdef ESP_PLATFORM
+#include "esp_partition.h"  // Not used by the host tools
+#endif
+
+static const char *TAG = "ASSETS";
+
+static const asset_pack_header_t *pack = NULL;
+static const asset_entry_t *entries = NULL;
+static const uint16_t *slots = NULL;
+
+uint32_t asset_name_hash(const char *name) {
+    uint32_t hash = 2166136261u;
+    while (*name) {
+        hash ^= (uint8_t)*name++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Bitwise CRC-32 (IEEE, same as Python's zlib.crc32); only run once on the tables
+static uint32_t crc32(const uint8_t *data, uint32_t len) {
+    uint32_t crc = 0xFFFFFFFFu;
+    for (uint32_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+bool asset_pack_open_mem(const uint8_t *data, uint32_t size) {
+    pack = NULL;
+    if (!data || size < sizeof(asset_pack_header_t)) {
+        return false;
+    }
+
+    const asset_pack_header_t *hdr = (const asset_pack_header_t *)data;
+    if (memcmp(hdr->magic, ASSET_PACK_MAGIC, ASSET_PACK_MAGIC_LEN) != 0) {
+        ESP_LOGW(TAG, "No asset pack (partition empty or not flashed)");
+        return false;
+    }
+    if (hdr->version != ASSET_PACK_VERSION) {
+        ESP_LOGE(TAG, "Asset pack version %d, expected %d", hdr->version, ASSET_PACK_VERSION);
+        return false;
+    }
+
+    // Slot count must be a power of two with room for every entry
+    uint32_t table_bytes = (uint32_t)hdr->count * sizeof(asset_entry_t) + (uint32_t)hdr->slot_count * sizeof(uint16_t);
+    if (hdr->slot_count == 0 || (hdr->slot_count & (hdr->slot_count - 1)) != 0 || hdr->slot_count <= hdr->count ||
+        hdr->total_size > size || sizeof(asset_pack_header_t) + table_bytes > hdr->total_size) {
+        ESP_LOGE(TAG, "Asset pack header is invalid (%lu bytes, %d assets)",
+                 (unsigned long)hdr->total_size, hdr->count);
+        return false;
+    }
+
+    const uint8_t *tables = data + sizeof(asset_pack_header_t);
+    if (crc32(tables, table_bytes) != hdr->table_crc) {
+        ESP_LOGE(TAG, "Asset pack table CRC mismatch");
+        return false;
+    }
+
+    const asset_entry_t *list = (const asset_entry_t *)tables;
+    for (uint16_t i = 0; i < hdr->count; i++) {
+        if (list[i].offset > hdr->total_size || list[i].size > hdr->total_size - list[i].offset ||
+            list[i].name[ASSET_NAME_MAX - 1] != '\0') {
+            ESP_LOGE(TAG, "Asset %d is out of bounds", i);
+            return false;
+        }
+    }
+
+    const uint16_t *table = (const uint16_t *)(tables + (uint32_t)hdr->count * sizeof(asset_entry_t));
+    for (uint16_t i = 0; i < hdr->slot_count; i++) {
+        if (table[i] > hdr->count) {
+            ESP_LOGE(TAG, "Asset slot %d points past the entries", i);
+            return false;
+        }
+    }
+
+    entries = list;
+    slots = table;
+    pack = hdr;
+    return true;
+}
+
+bool asset_pack_init(void) {
+    if (pack != NULL) {
+        return true;
+    }
+#ifdef ESP_PLATFORM
+    const esp_partition_t *part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                                           (esp_partition_subtype_t)ASSET_PACK_SUBTYPE,
+                                                           ASSET_PACK_PARTITION);
+    if (part == NULL) {
+        ESP_LOGW(TAG, "No \"%s\" partition", ASSET_PACK_PARTITION);
+        return false;
+    }
+
+    // Map the whole partition once; lookups are then pointer arithmetic
+    const void *map = NULL;
+    esp_partition_mmap_handle_t handle;
+    esp_err_t err = esp_partition_mmap(part, 0, part->size, ESP_PARTITION_MMAP_DATA, &map, &handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to map \"%s\": %s", ASSET_PACK_PARTITION, esp_err_to_name(err));
+        return false;
+    }
+    if (!asset_pack_open_mem((const uint8_t *)map, part->size)) {
+        esp_partition_munmap(handle);
+        return false;
+    }
+
+    ESP_LOGI(TAG, "Mapped %d assets (%lu / %lu KB) from 0x%lx", pack->count,
+             (unsigned long)(pack->total_size / 1024), (unsigned long)(part->size / 1024),
+             (unsigned long)part->address);
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool asset_pack_ready(void) {
+    return pack != NULL;
+}
+
+uint16_t asset_pack_count(void) {
+    return pack ? pack->count : 0;
+}
+
+bool asset_pack_get(uint16_t id, asset_t *out) {
+    if (pack == NULL || id >= pack->count) {
+        return false;
+    }
+    const asset_entry_t *entry = &entries[id];
+    out->data = (const uint8_t *)pack + entry->offset;
+    out->size = entry->size;
+    out->id = id;
+    out->type = entry->type;
+    out->name = entry->name;
+    return true;
+}
+
+bool asset_pack_find(const char *name, asset_t *out) {
+    if (pack == NULL || name == NULL) {
+        return false;
+    }
+
+    uint32_t hash = asset_name_hash(name);
+    uint32_t mask = pack->slot_count - 1;
+
+    // Linear probing; the table is at most half full, so probes are short
+    for (uint32_t i = 0; i < pack->slot_count; i++) {
+        uint16_t slot = slots[(hash + i) & mask];
+        if (slot == 0) {
+            return false;
+        }
+        const asset_entry_t *entry = &entries[slot - 1];
+        if (entry->name_hash == hash && strncmp(entry->name, name, ASSET_NAME_MAX) == 0) {
+            return asset_pack_get(slot - 1, out);
+        }
+    }
+    return false;
+}
@@ -0,0 +1,130 @@
+#ifndef ASSET_PACK_H
+#define ASSET_PACK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Memory-mapped asset pack
+ *
+ * Images live in their own flash partition ("assets", see partitions.csv) as
+ * one packed blob written by pack_assets.py. At startup the whole partition
+ * is mapped into the data address space with esp_partition_mmap(). Assets
+ * are then plain const pointers into flash; no file system is involved, and
+ * flashing new assets does not need a firmware rebuild.
+ *
+ * Layout (little-endian, all offsets from the start of the pack):
+ *   asset_pack_header_t
+ *   asset_entry_t[count]         indexed by asset ID (0 .. count - 1)
+ *   uint16_t slots[slot_count]   open-addressed name hash table: ID + 1, 0 = empty
+ *   asset data, each ASSET_PACK_ALIGN-aligned
+ *
+ * Lookup by ID is an array index. Lookup by name hashes the name (FNV-1a),
+ * probes the slot table from hash & (slot_count - 1) and compares the stored
+ * hash and name; the packer keeps the table at most half full.
+ */
+
+#define ASSET_PACK_MAGIC          "NYAP"
+#define ASSET_PACK_MAGIC_LEN      4
+#define ASSET_PACK_VERSION        1
+#define ASSET_PACK_ALIGN          64     // Data alignment (cache line)
+#define ASSET_NAME_MAX            24     // Including the terminating NUL
+
+#define ASSET_PACK_PARTITION      "assets"
+#define ASSET_PACK_SUBTYPE        0x40   // Custom data subtype in partitions.csv
+
+// Asset content, detected by the packer from the file's magic bytes
+typedef enum {
+    ASSET_TYPE_BLOB  = 0,  // Anything else
+    ASSET_TYPE_FRAME = 1,  // NYF1 frame (lib/FRAME/frame_format.h)
+    ASSET_TYPE_JPEG  = 2,  // Baseline JPEG (lib/FRAME/frame_jpeg.h)
+    ASSET_TYPE_RAW   = 3,  // Headerless panel-ready RGB565
+} asset_type_t;
+
+typedef struct __attribute__((packed)) {
+    char magic[ASSET_PACK_MAGIC_LEN];  // "NYAP"
+    uint16_t version;                  // ASSET_PACK_VERSION
+    uint16_t count;                    // Entries
+    uint16_t slot_count;               // Name hash slots (power of two)
+    uint16_t reserved;
+    uint32_t total_size;               // Bytes including header, tables and data
+    uint32_t table_crc;                // CRC-32 of the entry and slot tables
+    uint8_t pad[12];
+} asset_pack_header_t;
+
+_Static_assert(sizeof(asset_pack_header_t) == 32, "asset_pack_header_t must be 32 bytes");
+
+typedef struct __attribute__((packed)) {
+    uint32_t name_hash;                // FNV-1a of name
+    uint32_t offset;                   // Data offset from the start of the pack
+    uint32_t size;                     // Data bytes
+    uint16_t type;                     // asset_type_t
+    uint16_t reserved;
+    char name[ASSET_NAME_MAX];         // NUL-padded
+} asset_entry_t;
+
+_Static_assert(sizeof(asset_entry_t) == 40, "asset_entry_t must be 40 bytes");
+
+// Resolved asset; data points into the mapped partition
+typedef struct {
+    const uint8_t *data;
+    uint32_t size;
+    uint16_t id;
+    uint16_t type;                     // asset_type_t
+    const char *name;
+} asset_t;
+
+/**
+ * @brief Map the asset partition and validate its pack
+ * @return true if a valid pack is mapped (also when already initialized)
+ */
+bool asset_pack_init(void);
+
+/**
+ * @brief Use a pack that is already in memory (host tools, tests)
+ * @param data Pack bytes, starting with the header
+ * @param size Bytes available at data
+ * @return true if the pack is valid
+ */
+bool asset_pack_open_mem(const uint8_t *data, uint32_t size);
+
+/**
+ * @brief Whether a pack is available
+ */
+bool asset_pack_ready(void);
+
+/**
+ * @brief Number of assets in the pack (0 if none)
+ */
+uint16_t asset_pack_count(void);
+
+/**
+ * @brief Find an asset by name
+ * @param name Asset name as given to pack_assets.py
+ * @param out Filled on success
+ * @return true if found
+ */
+bool asset_pack_find(const char *name, asset_t *out);
+
+/**
+ * @brief Get an asset by ID (its position in the pack manifest)
+ * @param id Asset ID
+ * @param out Filled on success
+ * @return true if id is valid
+ */
+bool asset_pack_get(uint16_t id, asset_t *out);
+
+/**
+ * @brief FNV-1a hash used for name lookup (matches pack_assets.py)
+ */
+uint32_t asset_name_hash(const char *name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ASSET_PACK_H
@@ -0,0 +1,160 @@
+#include "boot_graph.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/event_groups.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "BOOT";
+
+typedef struct {
+    const char *name;
+    int64_t start_us;
+    int64_t end_us;         // == start_us for instant marks
+    int8_t core;            // -1 for marks
+    bool ok;
+} timeline_entry_t;
+
+static timeline_entry_t timeline[BOOT_TIMELINE_MAX];
+static int timeline_count = 0;
+static portMUX_TYPE timeline_mux = portMUX_INITIALIZER_UNLOCKED;
+
+typedef struct {
+    const boot_stage_t *stage;
+    int index;
+    EventGroupHandle_t done;
+    bool *results;
+} stage_run_t;
+
+static void timeline_add(const char *name, int64_t start_us, int64_t end_us, int core, bool ok) {
+    taskENTER_CRITICAL(&timeline_mux);
+    if (timeline_count < BOOT_TIMELINE_MAX) {
+        timeline[timeline_count++] = (timeline_entry_t){
+            .name = name, .start_us = start_us, .end_us = end_us, .core = core, .ok = ok,
+        };
+    }
+    taskEXIT_CRITICAL(&timeline_mux);
+}
+
+static void stage_task_fn(void *arg) {
+    stage_run_t *run = arg;
+    const boot_stage_t *stage = run->stage;
+
+    if (stage->deps) {
+        xEventGroupWaitBits(run->done, stage->deps, pdFALSE, pdTRUE, portMAX_DELAY);
+    }
+
+    bool deps_ok = true;
+    for (int i = 0; i < BOOT_GRAPH_MAX_STAGES; i++) {
+        if ((stage->deps & BOOT_DEP(i)) && !run->results[i]) {
+            deps_ok = false;
+        }
+    }
+
+    int64_t start = esp_timer_get_time();
+    bool ok = false;
+    if (deps_ok) {
+        ok = stage->fn(stage->ctx);
+    } else {
+        ESP_LOGW(TAG, "Skipping %s: a dependency failed", stage->name);
+    }
+    timeline_add(stage->name, start, esp_timer_get_time(), xPortGetCoreID(), ok);
+
+    run->results[run->index] = ok;
+    xEventGroupSetBits(run->done, BOOT_DEP(run->index));
+    vTaskDelete(NULL);
+}
+
+bool boot_graph_run(const boot_stage_t *stages, int count, bool *ok) {
+    if (stages == NULL || count <= 0 || count > BOOT_GRAPH_MAX_STAGES) {
+        return false;
+    }
+
+    static bool results[BOOT_GRAPH_MAX_STAGES];
+    static stage_run_t runs[BOOT_GRAPH_MAX_STAGES];
+    memset(results, 0, sizeof(results));
+
+    EventGroupHandle_t done = xEventGroupCreate();
+    if (done == NULL) {
+        return false;
+    }
+
+    uint32_t all = 0;
+    for (int i = 0; i < count; i++) {
+        runs[i] = (stage_run_t){ .stage = &stages[i], .index = i, .done = done, .results = results };
+        uint16_t stack = stages[i].stack_size ? stages[i].stack_size : BOOT_GRAPH_STACK_SIZE;
+        if (xTaskCreate(stage_task_fn, stages[i].name, stack, &runs[i], BOOT_GRAPH_PRIORITY, NULL) != pdPASS) {
+            // Mark it finished and failed so dependants do not wait forever
+            ESP_LOGE(TAG, "Failed to create task for %s", stages[i].name);
+            results[i] = false;
+            xEventGroupSetBits(done, BOOT_DEP(i));
+        }
+        all |= BOOT_DEP(i);
+    }
+
+    xEventGroupWaitBits(done, all, pdFALSE, pdTRUE, portMAX_DELAY);
+    vEventGroupDelete(done);
+
+    bool all_ok = true;
+    for (int i = 0; i < count; i++) {
+        if (ok) {
+            ok[i] = results[i];
+        }
+        all_ok &= results[i];
+    }
+    return all_ok;
+}
+
+void boot_timeline_mark(const char *name) {
+    int64_t now = esp_timer_get_time();
+    timeline_add(name, now, now, -1, true);
+}
+
+int64_t boot_timeline_end_us(const char *name) {
+    int64_t end = -1;
+    taskENTER_CRITICAL(&timeline_mux);
+    for (int i = 0; i < timeline_count; i++) {
+        if (strcmp(timeline[i].name, name) == 0) {
+            end = timeline[i].end_us;
+        }
+    }
+    taskEXIT_CRITICAL(&timeline_mux);
+    return end;
+}
+
+void boot_timeline_print(void) {
+    timeline_entry_t entries[BOOT_TIMELINE_MAX];
+    taskENTER_CRITICAL(&timeline_mux);
+    int count = timeline_count;
+    memcpy(entries, timeline, count * sizeof(timeline_entry_t));
+    taskEXIT_CRITICAL(&timeline_mux);
+
+    int64_t last = 0;
+    for (int i = 0; i < count; i++) {
+        if (entries[i].end_us > last) {
+            last = entries[i].end_us;
+        }
+    }
+    if (last <= 0) {
+        return;
+    }
+
+    // Chart scaled to the latest end time, 50 columns
+    printf("BOOT,name,core,start_us,end_us,duration_us,ok\n");
+    for (int i = 0; i < count; i++) {
+        const timeline_entry_t *e = &entries[i];
+        char bar[51];
+        int from = (int)(e->start_us * 50 / last);
+        int to = (int)(e->end_us * 50 / last);
+        memset(bar, ' ', 50);
+        for (int c = from; c <= to && c < 50; c++) {
+            bar[c] = e->core < 0 ? '|' : '=';
+        }
+        bar[50] = '\0';
+        printf("BOOT,%s,%d,%lld,%lld,%lld,%d  [%s]\n", e->name, e->core,
+               (long long)e->start_us, (long long)e->end_us,
+               (long long)(e->end_us - e->start_us), e->ok ? 1 : 0, bar);
+    }
+}
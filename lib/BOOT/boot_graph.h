@@ -0,0 +1,70 @@
+#ifndef BOOT_GRAPH_H
+#define BOOT_GRAPH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Boot initialization as a dependency graph
+ *
+ * Each stage runs in its own short-lived task as soon as the stages it
+ * depends on have finished, so independent peripherals (display, touch,
+ * storage) initialize concurrently and boot takes the longest dependency
+ * chain instead of the sum of every init. A stage whose dependency failed
+ * is skipped and counts as failed.
+ *
+ * Every stage's start and end (esp_timer µs since startup) goes into a boot
+ * timeline, together with instant marks from boot_timeline_mark(), and can
+ * be printed with boot_timeline_print().
+ */
+
+#define BOOT_GRAPH_MAX_STAGES   16
+#define BOOT_GRAPH_STACK_SIZE   4096
+#define BOOT_GRAPH_PRIORITY     5
+#define BOOT_TIMELINE_MAX       32
+
+#define BOOT_DEP(index)         (1u << (index))
+
+typedef bool (*boot_stage_fn_t)(void *ctx);
+
+typedef struct {
+    const char *name;
+    boot_stage_fn_t fn;
+    void *ctx;
+    uint32_t deps;          // BOOT_DEP() of each stage (by index) that must finish first
+    uint16_t stack_size;    // 0 = BOOT_GRAPH_STACK_SIZE
+} boot_stage_t;
+
+/**
+ * @brief Run the stages and wait for all of them
+ * @param stages Stage table (dependencies must point to other entries)
+ * @param count Number of stages (<= BOOT_GRAPH_MAX_STAGES)
+ * @param ok Optional per-stage results (count entries)
+ * @return true if every stage succeeded
+ */
+bool boot_graph_run(const boot_stage_t *stages, int count, bool *ok);
+
+/**
+ * @brief Record an instant in the boot timeline
+ */
+void boot_timeline_mark(const char *name);
+
+/**
+ * @brief End time of a timeline entry by name (µs), or -1 if not recorded
+ */
+int64_t boot_timeline_end_us(const char *name);
+
+/**
+ * @brief Print the timeline, one "BOOT,..." line per entry, with a bar chart
+ */
+void boot_timeline_print(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BOOT_GRAPH_H
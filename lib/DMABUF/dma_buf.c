@@ -0,0 +1,182 @@
+#include "dma_buf.h"
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+
+static const char *TAG = "DMA_BUF";
+
+#define DMA_BUF_MAGIC  0x444D4142  // "DMAB"
+#define DMA_BUF_CAPS   (MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL)
+
+struct dma_buf {
+    uint32_t magic;
+    uint32_t refs;
+    size_t size;
+    const char *owner;
+    struct dma_buf *prev;       // Live list, for the stats log
+    struct dma_buf *next;
+};
+
+// Data starts one cache line-aligned header after the allocation
+#define HEADER_SIZE  ((sizeof(struct dma_buf) + DMA_BUF_ALIGN - 1) & ~(size_t)(DMA_BUF_ALIGN - 1))
+
+static portMUX_TYPE buf_mux = portMUX_INITIALIZER_UNLOCKED;
+static dma_buf_t *live_list = NULL;
+static dma_buf_stats_t stats;
+static size_t reserve = DMA_BUF_DEFAULT_RESERVE;
+
+dma_buf_t* dma_buf_alloc(size_t size, const char* owner) {
+    if (size == 0) {
+        return NULL;
+    }
+    size = (size + DMA_BUF_ALIGN - 1) & ~(size_t)(DMA_BUF_ALIGN - 1);
+    size_t total = HEADER_SIZE + size;
+
+    // Keep the reserve for USB and the other internal-RAM users
+    size_t internal_free = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    if (internal_free < total || internal_free - total < reserve) {
+        taskENTER_CRITICAL(&buf_mux);
+        stats.refused++;
+        taskEXIT_CRITICAL(&buf_mux);
+        ESP_LOGW(TAG, "Refused %u bytes for %s: %u free, %u reserved",
+                 (unsigned)size, owner ? owner : "?", (unsigned)internal_free, (unsigned)reserve);
+        return NULL;
+    }
+
+    dma_buf_t *buf = heap_caps_aligned_alloc(DMA_BUF_ALIGN, total, DMA_BUF_CAPS);
+    if (buf == NULL) {
+        taskENTER_CRITICAL(&buf_mux);
+        stats.failed++;
+        taskEXIT_CRITICAL(&buf_mux);
+        ESP_LOGE(TAG, "Failed to allocate %u bytes for %s", (unsigned)size, owner ? owner : "?");
+        return NULL;
+    }
+
+    buf->magic = DMA_BUF_MAGIC;
+    buf->refs = 1;
+    buf->size = size;
+    buf->owner = owner ? owner : "?";
+    buf->prev = NULL;
+
+    taskENTER_CRITICAL(&buf_mux);
+    buf->next = live_list;
+    if (live_list) {
+        live_list->prev = buf;
+    }
+    live_list = buf;
+    stats.live++;
+    stats.allocs++;
+    stats.bytes += size;
+    if (stats.bytes > stats.peak_bytes) {
+        stats.peak_bytes = stats.bytes;
+    }
+    taskEXIT_CRITICAL(&buf_mux);
+    return buf;
+}
+
+dma_buf_t* dma_buf_ref(dma_buf_t* buf) {
+    if (buf) {
+        taskENTER_CRITICAL(&buf_mux);
+        buf->refs++;
+        taskEXIT_CRITICAL(&buf_mux);
+    }
+    return buf;
+}
+
+void dma_buf_unref(dma_buf_t* buf) {
+    if (buf == NULL) {
+        return;
+    }
+
+    taskENTER_CRITICAL(&buf_mux);
+    bool last = --buf->refs == 0;
+    if (last) {
+        if (buf->prev) {
+            buf->prev->next = buf->next;
+        } else {
+            live_list = buf->next;
+        }
+        if (buf->next) {
+            buf->next->prev = buf->prev;
+        }
+        stats.live--;
+        stats.frees++;
+        stats.bytes -= buf->size;
+    }
+    taskEXIT_CRITICAL(&buf_mux);
+
+    if (last) {
+        buf->magic = 0;
+        heap_caps_free(buf);
+    }
+}
+
+void* dma_buf_data(const dma_buf_t* buf) {
+    return buf ? (uint8_t*)buf + HEADER_SIZE : NULL;
+}
+
+size_t dma_buf_size(const dma_buf_t* buf) {
+    return buf ? buf->size : 0;
+}
+
+dma_buf_t* dma_buf_from_data(const void* ptr) {
+    if (ptr == NULL || ((uintptr_t)ptr & (DMA_BUF_ALIGN - 1)) != 0) {
+        return NULL;
+    }
+    dma_buf_t *buf = (dma_buf_t*)((uint8_t*)ptr - HEADER_SIZE);
+
+    // Only trust the header of a buffer on the live list
+    dma_buf_t *found = NULL;
+    taskENTER_CRITICAL(&buf_mux);
+    for (dma_buf_t *b = live_list; b != NULL; b = b->next) {
+        if (b == buf) {
+            found = b;
+            break;
+        }
+    }
+    taskEXIT_CRITICAL(&buf_mux);
+    return found;
+}
+
+void dma_buf_set_reserve(size_t bytes) {
+    reserve = bytes;
+}
+
+void dma_buf_get_stats(dma_buf_stats_t* out) {
+    if (out == NULL) {
+        return;
+    }
+    taskENTER_CRITICAL(&buf_mux);
+    *out = stats;
+    taskEXIT_CRITICAL(&buf_mux);
+    out->internal_free = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    out->internal_min_free = heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL);
+}
+
+void dma_buf_log_stats(void) {
+    dma_buf_stats_t s;
+    dma_buf_get_stats(&s);
+    ESP_LOGI(TAG, "%lu live, %u bytes (peak %u), %lu allocs, %lu frees, %lu refused, %lu failed",
+             (unsigned long)s.live, (unsigned)s.bytes, (unsigned)s.peak_bytes,
+             (unsigned long)s.allocs, (unsigned long)s.frees,
+             (unsigned long)s.refused, (unsigned long)s.failed);
+    ESP_LOGI(TAG, "Internal RAM: %u free, %u minimum, %u reserved",
+             (unsigned)s.internal_free, (unsigned)s.internal_min_free, (unsigned)reserve);
+
+    // Snapshot under the lock, log outside it
+    struct { const char *owner; size_t size; uint32_t refs; } live[16];
+    int n = 0;
+    taskENTER_CRITICAL(&buf_mux);
+    for (dma_buf_t *b = live_list; b != NULL && n < 16; b = b->next) {
+        live[n].owner = b->owner;
+        live[n].size = b->size;
+        live[n].refs = b->refs;
+        n++;
+    }
+    taskEXIT_CRITICAL(&buf_mux);
+    for (int i = 0; i < n; i++) {
+        ESP_LOGI(TAG, "  %-12s %6u bytes, %lu refs", live[i].owner, (unsigned)live[i].size,
+                 (unsigned long)live[i].refs);
+    }
+}
@@ -0,0 +1,102 @@
+#ifndef DMA_BUF_H
+#define DMA_BUF_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Reference-counted DMA buffers shared by the SD and display paths
+ *
+ * Every buffer is MALLOC_CAP_DMA internal RAM, starts on a cache-line
+ * boundary and is a whole number of cache lines long. That is what the
+ * SPI master and SDMMC/SDSPI drivers need to DMA straight from/to the
+ * caller's memory; anything else makes them allocate a bounce buffer and
+ * memcpy every transfer. A buffer filled by sd_read_sectors() / sd_raw_read()
+ * can therefore go to ili9341_write_pixels() as is.
+ *
+ * Internal RAM is shared with the USB-Serial/JTAG and TinyUSB stacks, which
+ * stop working when it runs out. Allocations that would leave less than the
+ * reserve (dma_buf_set_reserve()) free are refused and counted; callers fall
+ * back to smaller buffers or skip the feature.
+ *
+ * The header sits in the same allocation, in front of the data, so a buffer
+ * costs one heap block and the data pointer maps back to its handle.
+ */
+
+#define DMA_BUF_ALIGN            64               // Covers the 32 B internal and 64 B PSRAM cache lines
+#define DMA_BUF_DEFAULT_RESERVE  (48 * 1024)      // Internal RAM kept free for USB and drivers
+
+typedef struct dma_buf dma_buf_t;
+
+typedef struct {
+    uint32_t live;              // Buffers currently allocated
+    size_t bytes;               // Data bytes currently allocated
+    size_t peak_bytes;          // Highest value of bytes
+    uint32_t allocs;
+    uint32_t frees;
+    uint32_t refused;           // Allocations refused to keep the reserve
+    uint32_t failed;            // Allocations the heap could not satisfy
+    size_t internal_free;       // Free internal RAM when the stats were read
+    size_t internal_min_free;   // Lowest free internal RAM since boot
+} dma_buf_stats_t;
+
+/**
+ * @brief Allocate a DMA-capable, cache-line-aligned buffer with one reference
+ * @param size Data bytes (rounded up to DMA_BUF_ALIGN)
+ * @param owner Short static name for the stats log (e.g. "compositor")
+ * @return Buffer handle, or NULL if refused or out of memory
+ */
+dma_buf_t* dma_buf_alloc(size_t size, const char* owner);
+
+/**
+ * @brief Take another reference (returns buf for chaining)
+ */
+dma_buf_t* dma_buf_ref(dma_buf_t* buf);
+
+/**
+ * @brief Drop a reference; the buffer is freed when the last one goes (NULL is ignored)
+ */
+void dma_buf_unref(dma_buf_t* buf);
+
+/**
+ * @brief Data pointer of a buffer (DMA_BUF_ALIGN aligned)
+ */
+void* dma_buf_data(const dma_buf_t* buf);
+
+/**
+ * @brief Usable size of a buffer in bytes
+ */
+size_t dma_buf_size(const dma_buf_t* buf);
+
+/**
+ * @brief Handle of the buffer whose data starts at ptr
+ * @return Handle, or NULL if ptr is not the start of a dma_buf
+ */
+dma_buf_t* dma_buf_from_data(const void* ptr);
+
+/**
+ * @brief Set the internal RAM that allocations must leave free
+ * @param bytes Reserve in bytes (DMA_BUF_DEFAULT_RESERVE until called)
+ */
+void dma_buf_set_reserve(size_t bytes);
+
+/**
+ * @brief Get allocator statistics
+ */
+void dma_buf_get_stats(dma_buf_stats_t* out);
+
+/**
+ * @brief Log the statistics and every live buffer
+ */
+void dma_buf_log_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DMA_BUF_H
@@ -0,0 +1,106 @@
+#include "frame_cache.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include <string.h>
+
+static const char *TAG = "FRAME_CACHE";
+
+bool frame_cache_init(frame_cache_t *cache, uint8_t frame_count, uint16_t width, uint16_t height) {
+    if (!cache) {
+        return false;
+    }
+
+    memset(cache, 0, sizeof(frame_cache_t));
+    cache->frame_count = frame_count > FRAME_CACHE_MAX_FRAMES ? FRAME_CACHE_MAX_FRAMES : frame_count;
+    cache->frame_bytes = (uint32_t)width * height * sizeof(uint16_t);
+
+    size_t psram_total = heap_caps_get_total_size(MALLOC_CAP_SPIRAM);
+    if (psram_total == 0) {
+        ESP_LOGI(TAG, "No PSRAM - frames will be streamed every loop");
+        return false;
+    }
+
+    cache->available = true;
+    ESP_LOGI(TAG, "PSRAM cache ready: %d frames x %lu bytes (%u KB PSRAM free)",
+             cache->frame_count, (unsigned long)cache->frame_bytes,
+             (unsigned)(heap_caps_get_free_size(MALLOC_CAP_SPIRAM) / 1024));
+    return true;
+}
+
+const uint16_t *frame_cache_lookup(frame_cache_t *cache, uint8_t index) {
+    if (!cache || index >= cache->frame_count) {
+        return NULL;
+    }
+    if (cache->valid[index]) {
+        cache->hits++;
+        return cache->frames[index];
+    }
+    cache->misses++;
+    return NULL;
+}
+
+uint16_t *frame_cache_reserve(frame_cache_t *cache, uint8_t index) {
+    if (!cache || !cache->available || index >= cache->frame_count) {
+        return NULL;
+    }
+    if (cache->frames[index] != NULL) {
+        return cache->frames[index];  // Earlier fill failed part way, reuse the slot
+    }
+    if (cache->full) {
+        return NULL;
+    }
+
+    // Keep some PSRAM back so the cache never starves other users
+    if (heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM) < cache->frame_bytes + FRAME_CACHE_PSRAM_RESERVE) {
+        ESP_LOGW(TAG, "PSRAM full after %d frames - remaining frames will be streamed", index);
+        cache->full = true;
+        return NULL;
+    }
+
+    cache->frames[index] = heap_caps_aligned_alloc(FRAME_CACHE_ALIGN, cache->frame_bytes, MALLOC_CAP_SPIRAM);
+    if (cache->frames[index] == NULL) {
+        ESP_LOGW(TAG, "PSRAM allocation failed for frame %d", index);
+        cache->full = true;
+    }
+    return cache->frames[index];
+}
+
+void frame_cache_commit(frame_cache_t *cache, uint8_t index, bool ok) {
+    if (!cache || index >= cache->frame_count || cache->frames[index] == NULL) {
+        return;
+    }
+    cache->valid[index] = ok;
+}
+
+void frame_cache_log_stats(const frame_cache_t *cache) {
+    if (!cache) {
+        return;
+    }
+
+    uint8_t cached = 0;
+    for (int i = 0; i < cache->frame_count; i++) {
+        if (cache->valid[i]) cached++;
+    }
+
+    uint32_t lookups = cache->hits + cache->misses;
+    ESP_LOGI(TAG, "Hits: %lu / %lu (%lu%%), %d/%d frames cached (%lu KB PSRAM)%s",
+             (unsigned long)cache->hits, (unsigned long)lookups,
+             (unsigned long)(lookups ? cache->hits * 100 / lookups : 0),
+             cached, cache->frame_count,
+             (unsigned long)(cached * cache->frame_bytes / 1024),
+             cache->available ? (cache->full ? ", PSRAM full" : "") : ", no PSRAM");
+}
+
+void frame_cache_deinit(frame_cache_t *cache) {
+    if (!cache) {
+        return;
+    }
+    for (int i = 0; i < FRAME_CACHE_MAX_FRAMES; i++) {
+        if (cache->frames[i] != NULL) {
+            heap_caps_free(cache->frames[i]);
+            cache->frames[i] = NULL;
+        }
+        cache->valid[i] = false;
+    }
+    cache->full = false;
+}
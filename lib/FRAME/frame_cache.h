@@ -0,0 +1,80 @@
+#ifndef FRAME_CACHE_H
+#define FRAME_CACHE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * PSRAM-resident cache of decoded animation frames
+ *
+ * Frames are decoded straight into PSRAM the first time they are played and
+ * sent to the panel from there on every later loop, so the SD card is only
+ * read once per frame. Without PSRAM (or once it is full) callers fall back
+ * to streaming.
+ */
+
+#define FRAME_CACHE_MAX_FRAMES   16
+#define FRAME_CACHE_ALIGN        64          // Cache-line aligned for GDMA access to PSRAM
+#define FRAME_CACHE_PSRAM_RESERVE (64 * 1024) // Left free for other PSRAM users
+
+typedef struct {
+    uint16_t *frames[FRAME_CACHE_MAX_FRAMES];  // Decoded RGB565 frames in PSRAM
+    bool valid[FRAME_CACHE_MAX_FRAMES];        // Frame completely decoded
+    uint16_t durations[FRAME_CACHE_MAX_FRAMES]; // Frame duration from the asset header
+    uint8_t frame_count;
+    uint32_t frame_bytes;
+    bool available;                            // PSRAM present and usable
+    bool full;                                 // An allocation failed, stop filling
+    uint32_t hits;
+    uint32_t misses;
+} frame_cache_t;
+
+/**
+ * @brief Initialize the cache (no memory is allocated until frames are filled)
+ * @param cache Cache state
+ * @param frame_count Frames in the animation (max FRAME_CACHE_MAX_FRAMES)
+ * @param width Frame width in pixels
+ * @param height Frame height in pixels
+ * @return true if PSRAM is available for caching
+ */
+bool frame_cache_init(frame_cache_t *cache, uint8_t frame_count, uint16_t width, uint16_t height);
+
+/**
+ * @brief Look up a decoded frame, counting a hit or a miss
+ * @return Frame pixels in PSRAM, or NULL if the frame must be streamed
+ */
+const uint16_t *frame_cache_lookup(frame_cache_t *cache, uint8_t index);
+
+/**
+ * @brief Get a PSRAM buffer to decode a missed frame into
+ * @return Frame buffer, or NULL if PSRAM is absent or full
+ */
+uint16_t *frame_cache_reserve(frame_cache_t *cache, uint8_t index);
+
+/**
+ * @brief Mark a reserved frame as complete (ok) or drop it (decode failed)
+ */
+void frame_cache_commit(frame_cache_t *cache, uint8_t index, bool ok);
+
+/**
+ * @brief Log hit rate and PSRAM usage
+ */
+void frame_cache_log_stats(const frame_cache_t *cache);
+
+/**
+ * @brief Free all cached frames
+ *
+ * The cache stays usable: frames are reserved and filled again on their
+ * next playback. Call only while no reader is filling or reading slots.
+ */
+void frame_cache_deinit(frame_cache_t *cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FRAME_CACHE_H
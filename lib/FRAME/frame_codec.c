@@ -0,0 +1,185 @@
+#include "frame_codec.h"
+#include <string.h>
+
+#define RING_MASK (FRAME_SRC_RING_SIZE - 1)
+
+void frame_src_init(frame_src_t *src, frame_src_fill_fn fill, void *ctx) {
+    src->rd = 0;
+    src->wr = 0;
+    src->fill = fill;
+    src->ctx = ctx;
+}
+
+// Top up the ring; returns bytes now available
+static uint32_t frame_src_refill(frame_src_t *src) {
+    while (src->wr - src->rd < FRAME_SRC_RING_SIZE) {
+        uint32_t free_bytes = FRAME_SRC_RING_SIZE - (src->wr - src->rd);
+        uint32_t pos = src->wr & RING_MASK;
+        uint32_t contiguous = FRAME_SRC_RING_SIZE - pos;
+        if (contiguous > free_bytes) {
+            contiguous = free_bytes;
+        }
+        size_t got = src->fill(src->ctx, &src->ring[pos], contiguous);
+        if (got == 0) {
+            break;  // End of input
+        }
+        src->wr += got;
+        if (got < contiguous) {
+            break;  // Short read - don't spin on a slow source
+        }
+    }
+    return src->wr - src->rd;
+}
+
+static inline bool frame_src_byte(frame_src_t *src, uint8_t *out) {
+    if (src->rd == src->wr && frame_src_refill(src) == 0) {
+        return false;
+    }
+    *out = src->ring[src->rd & RING_MASK];
+    src->rd++;
+    return true;
+}
+
+bool frame_src_read(frame_src_t *src, uint8_t *dst, uint32_t len) {
+    while (len > 0) {
+        uint32_t avail = src->wr - src->rd;
+        if (avail == 0) {
+            avail = frame_src_refill(src);
+            if (avail == 0) {
+                return false;
+            }
+        }
+        uint32_t pos = src->rd & RING_MASK;
+        uint32_t n = FRAME_SRC_RING_SIZE - pos;  // Up to the wrap point
+        if (n > avail) n = avail;
+        if (n > len) n = len;
+        memcpy(dst, &src->ring[pos], n);
+        src->rd += n;
+        dst += n;
+        len -= n;
+    }
+    return true;
+}
+
+bool frame_rle_decode(frame_src_t *src, uint32_t in_bytes, uint8_t *dst, uint32_t out_bytes, uint8_t elem_size) {
+    uint32_t consumed = 0;
+    uint32_t produced = 0;
+
+    if (elem_size != 1 && elem_size != 2) {
+        return false;
+    }
+
+    while (consumed < in_bytes) {
+        uint8_t ctrl;
+        if (!frame_src_byte(src, &ctrl)) return false;
+        consumed++;
+
+        uint32_t count = (ctrl & 0x7F) + 1;
+        uint32_t bytes = count * elem_size;
+        if (produced + bytes > out_bytes) {
+            return false;
+        }
+
+        if (ctrl & 0x80) {
+            // Run: one element repeated
+            uint8_t elem[2];
+            if (consumed + elem_size > in_bytes) return false;
+            if (!frame_src_read(src, elem, elem_size)) return false;
+            consumed += elem_size;
+
+            if (elem_size == 1) {
+                memset(dst + produced, elem[0], count);
+            } else if (elem[0] == elem[1]) {
+                memset(dst + produced, elem[0], bytes);
+            } else {
+                uint8_t *p = dst + produced;
+                for (uint32_t i = 0; i < count; i++) {
+                    p[0] = elem[0];
+                    p[1] = elem[1];
+                    p += 2;
+                }
+            }
+        } else {
+            // Literal elements
+            if (consumed + bytes > in_bytes) return false;
+            if (!frame_src_read(src, dst + produced, bytes)) return false;
+            consumed += bytes;
+        }
+        produced += bytes;
+    }
+
+    return produced == out_bytes;
+}
+
+// LZ4 extended length: keep adding bytes while they are 255
+static bool lz4_read_length(frame_src_t *src, uint32_t *len, uint32_t *consumed, uint32_t in_bytes) {
+    uint8_t b;
+    do {
+        if (*consumed >= in_bytes) return false;
+        if (!frame_src_byte(src, &b)) return false;
+        (*consumed)++;
+        *len += b;
+    } while (b == 255);
+    return true;
+}
+
+bool frame_lz4_decode(frame_src_t *src, uint32_t in_bytes, uint8_t *dst, uint32_t out_bytes) {
+    uint32_t consumed = 0;
+    uint32_t produced = 0;
+
+    while (consumed < in_bytes) {
+        uint8_t token;
+        if (!frame_src_byte(src, &token)) return false;
+        consumed++;
+
+        // Literals
+        uint32_t lit = token >> 4;
+        if (lit == 15 && !lz4_read_length(src, &lit, &consumed, in_bytes)) {
+            return false;
+        }
+        if (produced + lit > out_bytes || consumed + lit > in_bytes) {
+            return false;
+        }
+        if (!frame_src_read(src, dst + produced, lit)) return false;
+        produced += lit;
+        consumed += lit;
+
+        // The last sequence of a block carries literals only
+        if (consumed == in_bytes) {
+            break;
+        }
+
+        // Match
+        uint8_t off_buf[2];
+        if (consumed + 2 > in_bytes) return false;
+        if (!frame_src_read(src, off_buf, 2)) return false;
+        consumed += 2;
+        uint32_t offset = off_buf[0] | (off_buf[1] << 8);
+        if (offset == 0 || offset > produced) {
+            return false;
+        }
+
+        uint32_t match = token & 0x0F;
+        if (match == 15 && !lz4_read_length(src, &match, &consumed, in_bytes)) {
+            return false;
+        }
+        match += 4;
+        if (produced + match > out_bytes) {
+            return false;
+        }
+
+        uint8_t *out = dst + produced;
+        const uint8_t *ref = out - offset;
+        if (offset >= match) {
+            memcpy(out, ref, match);
+        } else {
+            // Overlapping match (e.g. run of a repeated pixel)
+            for (uint32_t i = 0; i < match; i++) {
+                out[i] = ref[i];
+            }
+        }
+        produced += match;
+    }
+
+    return produced == out_bytes;
+}
@@ -0,0 +1,74 @@
+#ifndef FRAME_CODEC_H
+#define FRAME_CODEC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Input ring size for compressed streams (must be a power of two)
+#define FRAME_SRC_RING_SIZE 2048
+
+/**
+ * Refill callback for the input ring
+ * @param ctx User context
+ * @param buf Destination
+ * @param len Maximum bytes to produce
+ * @return Bytes produced (0 at end of input)
+ */
+typedef size_t (*frame_src_fill_fn)(void *ctx, uint8_t *buf, size_t len);
+
+// Small input ring feeding the decompressors
+typedef struct {
+    uint8_t ring[FRAME_SRC_RING_SIZE];
+    uint32_t rd;                // Free-running read index
+    uint32_t wr;                // Free-running write index
+    frame_src_fill_fn fill;
+    void *ctx;
+} frame_src_t;
+
+/**
+ * @brief Initialize (or reset) an input ring
+ */
+void frame_src_init(frame_src_t *src, frame_src_fill_fn fill, void *ctx);
+
+/**
+ * @brief Copy bytes out of the ring, refilling as needed
+ * @return true if all bytes were available
+ */
+bool frame_src_read(frame_src_t *src, uint8_t *dst, uint32_t len);
+
+/**
+ * @brief Decode one RLE band
+ *
+ * Control byte c: bit 7 set = run of (c & 0x7F) + 1 copies of the next
+ * element, clear = c + 1 literal elements follow. Elements are 2 bytes for
+ * RGB565 data and 1 byte for indexed data.
+ *
+ * @param src Input ring
+ * @param in_bytes Compressed size of the band
+ * @param dst Output buffer
+ * @param out_bytes Exact decompressed size of the band
+ * @param elem_size Element size in bytes (1 or 2)
+ * @return true on success, false on corrupt or truncated input
+ */
+bool frame_rle_decode(frame_src_t *src, uint32_t in_bytes, uint8_t *dst, uint32_t out_bytes, uint8_t elem_size);
+
+/**
+ * @brief Decode one LZ4 block (standard LZ4 block format, no frame header)
+ * @param src Input ring
+ * @param in_bytes Compressed size of the block
+ * @param dst Output buffer (matches may only reference this band)
+ * @param out_bytes Exact decompressed size of the block
+ * @return true on success, false on corrupt or truncated input
+ */
+bool frame_lz4_decode(frame_src_t *src, uint32_t in_bytes, uint8_t *dst, uint32_t out_bytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FRAME_CODEC_H
@@ -0,0 +1,60 @@
+#include "frame_decode.h"
+
+/*
+ * All expansion kernels walk forward and read each source byte before the
+ * destination write that could overlap it. This lets callers place packed
+ * input at the END of the output buffer and expand in place: output pixel i
+ * never reaches past source byte i (8 bpp) or i/2 (4 bpp) for a buffer
+ * sized for the expanded data.
+ */
+
+void frame_build_pair_lut(const uint16_t *palette, uint16_t count, uint32_t *pair_lut) {
+    for (int b = 0; b < 256; b++) {
+        uint8_t hi = b >> 4;   // Left pixel
+        uint8_t lo = b & 0x0F; // Right pixel
+        uint32_t left = (hi < count) ? palette[hi] : 0;
+        uint32_t right = (lo < count) ? palette[lo] : 0;
+        // Little-endian: first pixel in the low half-word
+        pair_lut[b] = left | (right << 16);
+    }
+}
+
+void frame_expand_index8(const uint8_t *src, uint16_t *dst, uint32_t pixels, const uint16_t *palette) {
+    uint32_t i = 0;
+
+    // Unrolled by 4 - load all source bytes before any store
+    for (; i + 4 <= pixels; i += 4) {
+        uint8_t a = src[i];
+        uint8_t b = src[i + 1];
+        uint8_t c = src[i + 2];
+        uint8_t d = src[i + 3];
+        dst[i] = palette[a];
+        dst[i + 1] = palette[b];
+        dst[i + 2] = palette[c];
+        dst[i + 3] = palette[d];
+    }
+    for (; i < pixels; i++) {
+        dst[i] = palette[src[i]];
+    }
+}
+
+void frame_expand_index4(const uint8_t *src, uint16_t *dst, uint32_t pixels, const uint32_t *pair_lut) {
+    uint32_t *out = (uint32_t *)dst;
+    uint32_t pairs = pixels / 2;
+    uint32_t i = 0;
+
+    // One table lookup and one 32-bit store per packed byte
+    for (; i + 4 <= pairs; i += 4) {
+        uint8_t a = src[i];
+        uint8_t b = src[i + 1];
+        uint8_t c = src[i + 2];
+        uint8_t d = src[i + 3];
+        out[i] = pair_lut[a];
+        out[i + 1] = pair_lut[b];
+        out[i + 2] = pair_lut[c];
+        out[i + 3] = pair_lut[d];
+    }
+    for (; i < pairs; i++) {
+        out[i] = pair_lut[src[i]];
+    }
+}
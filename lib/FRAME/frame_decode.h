@@ -0,0 +1,40 @@
+#ifndef FRAME_DECODE_H
+#define FRAME_DECODE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Build a 256-entry pixel-pair LUT for 4 bpp expansion
+ * @param palette 16-entry panel-ready RGB565 palette
+ * @param count Number of valid palette entries (unused entries map to 0)
+ * @param pair_lut Output table, one 32-bit pixel pair per packed byte
+ */
+void frame_build_pair_lut(const uint16_t *palette, uint16_t count, uint32_t *pair_lut);
+
+/**
+ * @brief Expand 8 bpp indices to RGB565
+ * @param src Packed indices (one byte per pixel)
+ * @param dst Output pixels (may overlap src, see frame_stream.c)
+ * @param pixels Number of pixels to expand
+ * @param palette 256-entry palette
+ */
+void frame_expand_index8(const uint8_t *src, uint16_t *dst, uint32_t pixels, const uint16_t *palette);
+
+/**
+ * @brief Expand 4 bpp indices to RGB565 (two pixels per byte, high nibble first)
+ * @param src Packed indices
+ * @param dst Output pixels, must be 4-byte aligned (may overlap src)
+ * @param pixels Number of pixels to expand (must be even)
+ * @param pair_lut Table built by frame_build_pair_lut()
+ */
+void frame_expand_index4(const uint8_t *src, uint16_t *dst, uint32_t pixels, const uint32_t *pair_lut);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FRAME_DECODE_H
@@ -0,0 +1,115 @@
+#ifndef FRAME_FORMAT_H
+#define FRAME_FORMAT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Animation frame asset format (written by convert_nyan.py)
+ *
+ * Layout (all fields little-endian):
+ *   frame_header_t          16 bytes
+ *   palette                 palette_size x uint16_t (panel-ready RGB565)
+ *   pixel data              row-major, width * height pixels
+ *
+ * Compressed payloads (codec != FRAME_CODEC_NONE) are split into independent
+ * bands of band_lines lines. Each band is stored as a uint32_t compressed
+ * size followed by the compressed bytes of that band's encoded pixel data,
+ * so a band decodes straight into one display chunk buffer.
+ *
+ * Pixel data encodings:
+ *   FRAME_FMT_RGB565  2 bytes per pixel, already Swap+Invert transformed
+ *   FRAME_FMT_INDEX8  1 byte per pixel, index into palette
+ *   FRAME_FMT_INDEX4  2 pixels per byte, high nibble is the left pixel
+ *
+ * Codecs (applied to the encoded pixel data above):
+ *   FRAME_CODEC_NONE  Stored as-is
+ *   FRAME_CODEC_RLE   Byte-oriented RLE on 2-byte (RGB565) or 1-byte elements
+ *   FRAME_CODEC_LZ4   LZ4 block format, one block per band
+ *
+ * Palette entries carry the same Swap+Invert transformation as raw frames,
+ * so an index lookup yields a word that can be sent to the panel as-is.
+ *
+ * duration_ms carries the source frame delay (e.g. 100 for the 0.1 s Nyan
+ * frames) so the player can pace playback independently of read speed.
+ *
+ * Files without the magic are treated as legacy headerless 320x240 RGB565.
+ */
+
+#define FRAME_MAGIC          "NYF1"
+#define FRAME_MAGIC_LEN      4
+#define FRAME_MAX_PALETTE    256
+
+// Legacy raw frames (no header) are always full screen
+#define FRAME_LEGACY_WIDTH   320
+#define FRAME_LEGACY_HEIGHT  240
+
+typedef enum {
+    FRAME_FMT_RGB565 = 0,
+    FRAME_FMT_INDEX8 = 1,
+    FRAME_FMT_INDEX4 = 2,
+} frame_pixel_format_t;
+
+typedef enum {
+    FRAME_CODEC_NONE = 0,
+    FRAME_CODEC_RLE  = 1,
+    FRAME_CODEC_LZ4  = 2,
+} frame_codec_t;
+
+typedef struct __attribute__((packed)) {
+    char magic[FRAME_MAGIC_LEN];  // "NYF1"
+    uint16_t width;               // Pixels per line
+    uint16_t height;              // Lines per frame
+    uint8_t format;               // frame_pixel_format_t
+    uint8_t codec;                // frame_codec_t
+    uint16_t palette_size;        // Palette entries following the header
+    uint16_t band_lines;          // Lines per compressed band (0 if uncompressed)
+    uint16_t duration_ms;         // Display time of this frame (0 = player default)
+} frame_header_t;
+
+_Static_assert(sizeof(frame_header_t) == 16, "frame_header_t must be 16 bytes");
+
+static inline bool frame_header_is_valid(const frame_header_t *hdr) {
+    if (memcmp(hdr->magic, FRAME_MAGIC, FRAME_MAGIC_LEN) != 0) {
+        return false;
+    }
+    if (hdr->width == 0 || hdr->height == 0) {
+        return false;
+    }
+    if (hdr->codec > FRAME_CODEC_LZ4) {
+        return false;
+    }
+    if (hdr->codec != FRAME_CODEC_NONE && hdr->band_lines == 0) {
+        return false;
+    }
+    switch (hdr->format) {
+        case FRAME_FMT_RGB565:
+            return true;
+        case FRAME_FMT_INDEX8:
+            return hdr->palette_size > 0 && hdr->palette_size <= 256;
+        case FRAME_FMT_INDEX4:
+            return hdr->palette_size > 0 && hdr->palette_size <= 16 && (hdr->width & 1) == 0;
+        default:
+            return false;
+    }
+}
+
+// Bytes of encoded pixel data per line for a given format
+static inline uint32_t frame_line_bytes(uint8_t format, uint16_t width) {
+    switch (format) {
+        case FRAME_FMT_INDEX8: return width;
+        case FRAME_FMT_INDEX4: return width / 2;
+        default:               return (uint32_t)width * 2;
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FRAME_FORMAT_H
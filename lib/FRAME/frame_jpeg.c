@@ -0,0 +1,133 @@
+#include "frame_jpeg.h"
+#include "esp_log.h"
+#include <string.h>
+
+static const char *TAG = "FRAME_JPEG";
+
+// TJpgDec input callback: read len bytes, or skip them when buf is NULL
+static UINT jpeg_input(JDEC *jd, BYTE *buf, UINT len) {
+    frame_jpeg_t *jpeg = (frame_jpeg_t *)jd->device;
+
+    if (jpeg->file != NULL) {
+        if (buf == NULL) {
+            return fseek(jpeg->file, len, SEEK_CUR) == 0 ? len : 0;
+        }
+        return fread(buf, 1, len, jpeg->file);
+    }
+
+    uint32_t left = jpeg->mem_size - jpeg->mem_pos;
+    if (len > left) {
+        len = left;
+    }
+    if (buf != NULL) {
+        memcpy(buf, jpeg->mem + jpeg->mem_pos, len);
+    }
+    jpeg->mem_pos += len;
+    return len;
+}
+
+// TJpgDec output callback: one RGB888 MCU block at a time, left to right
+static UINT jpeg_output(JDEC *jd, void *bitmap, JRECT *rect) {
+    frame_jpeg_t *jpeg = (frame_jpeg_t *)jd->device;
+    const uint8_t *rgb = (const uint8_t *)bitmap;
+    uint16_t w = rect->right - rect->left + 1;
+
+    for (uint16_t y = rect->top; y <= rect->bottom; y++) {
+        uint16_t *dst = jpeg->band + (uint32_t)(y - jpeg->band_y) * jpeg->width + rect->left;
+        for (uint16_t x = 0; x < w; x++) {
+            // RGB888 to RGB565, then Swap+Invert for the panel
+            uint16_t c = ((rgb[0] & 0xF8) << 8) | ((rgb[1] & 0xFC) << 3) | (rgb[2] >> 3);
+            *dst++ = ~((c >> 8) | (c << 8));
+            rgb += 3;
+        }
+    }
+
+    // Last MCU of a row: hand the band over once another MCU row won't fit
+    if (rect->right == jpeg->width - 1) {
+        uint16_t filled = rect->bottom + 1 - jpeg->band_y;
+        if (filled + jpeg->mcu_lines > jpeg->batch_lines || rect->bottom + 1 >= jpeg->height) {
+            jpeg->band = jpeg->flush(jpeg->ctx, jpeg, jpeg->band_y, filled, jpeg->band);
+            jpeg->band_y = rect->bottom + 1;
+            if (jpeg->band == NULL) {
+                return 0;  // Interrupt decoding
+            }
+        }
+    }
+    return 1;
+}
+
+static bool jpeg_prepare(frame_jpeg_t *jpeg, const char *name) {
+    JRESULT res = jd_prepare(&jpeg->jdec, jpeg_input, jpeg->work, sizeof(jpeg->work), jpeg);
+    if (res != JDR_OK) {
+        ESP_LOGE(TAG, "Unsupported JPEG %s (error %d)", name, res);
+        return false;
+    }
+
+    jpeg->width = jpeg->jdec.width;
+    jpeg->height = jpeg->jdec.height;
+    jpeg->mcu_lines = jpeg->jdec.msy * 8;
+    return true;
+}
+
+bool frame_jpeg_open(frame_jpeg_t *jpeg, const char *path) {
+    if (!jpeg || !path) {
+        return false;
+    }
+
+    memset(jpeg, 0, sizeof(frame_jpeg_t));
+
+    jpeg->file = fopen(path, "rb");
+    if (jpeg->file == NULL) {
+        return false;
+    }
+
+    if (!jpeg_prepare(jpeg, path)) {
+        frame_jpeg_close(jpeg);
+        return false;
+    }
+    return true;
+}
+
+bool frame_jpeg_open_mem(frame_jpeg_t *jpeg, const uint8_t *data, uint32_t size) {
+    if (!jpeg || !data) {
+        return false;
+    }
+
+    memset(jpeg, 0, sizeof(frame_jpeg_t));
+    jpeg->mem = data;
+    jpeg->mem_size = size;
+
+    return jpeg_prepare(jpeg, "<memory>");
+}
+
+bool frame_jpeg_decode(frame_jpeg_t *jpeg, uint16_t *band, uint16_t band_lines,
+                       frame_jpeg_flush_fn flush, void *ctx) {
+    if (!jpeg || !band || !flush || band_lines < jpeg->mcu_lines) {
+        return false;
+    }
+
+    jpeg->band = band;
+    jpeg->band_y = 0;
+    jpeg->batch_lines = band_lines - band_lines % jpeg->mcu_lines;
+    jpeg->flush = flush;
+    jpeg->ctx = ctx;
+
+    JRESULT res = jd_decomp(&jpeg->jdec, jpeg_output, 0);
+    if (res != JDR_OK) {
+        if (res != JDR_INTR) {
+            ESP_LOGE(TAG, "JPEG decode failed (error %d)", res);
+        }
+        return false;
+    }
+    return true;
+}
+
+void frame_jpeg_close(frame_jpeg_t *jpeg) {
+    if (jpeg && jpeg->file != NULL) {
+        fclose(jpeg->file);
+        jpeg->file = NULL;
+    }
+    if (jpeg) {
+        jpeg->mem = NULL;
+    }
+}
@@ -0,0 +1,107 @@
+#ifndef FRAME_JPEG_H
+#define FRAME_JPEG_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "rom/tjpgd.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Baseline JPEG decoding with the TJpgDec decoder in the ESP32-S3 ROM
+ *
+ * Decoded MCU blocks are converted to panel-ready RGB565 (Swap+Invert) and
+ * collected in a caller-supplied band buffer. Whenever the band holds as
+ * many complete MCU rows as fit, the flush callback receives it as one
+ * window (e.g. to send with a single set_addr_window + DMA write) and
+ * returns the buffer to fill next.
+ *
+ * Assets are written by convert_nyan.py --format jpeg, convert_boot_logo.py
+ * --jpeg and tools/convert_images.py --jpeg (baseline only; progressive
+ * JPEGs are rejected by TJpgDec).
+ */
+
+#define FRAME_JPEG_WORK_SIZE  3100   // TJpgDec work area for the ROM build
+
+typedef struct frame_jpeg frame_jpeg_t;
+
+/**
+ * Band flush callback
+ * @param ctx User context
+ * @param jpeg Decoder (width/height of the image)
+ * @param y First image line in the band
+ * @param lines Lines in the band
+ * @param pixels Band pixels, jpeg->width per line
+ * @return Buffer for the next band (may be the same one), NULL to abort
+ */
+typedef uint16_t *(*frame_jpeg_flush_fn)(void *ctx, const frame_jpeg_t *jpeg,
+                                         uint16_t y, uint16_t lines, uint16_t *pixels);
+
+struct frame_jpeg {
+    uint16_t width;                 // Image size (valid after open)
+    uint16_t height;
+    uint16_t mcu_lines;             // MCU height: 8 (4:4:4) or 16 (4:2:0)
+
+    // Source
+    FILE *file;
+    const uint8_t *mem;
+    uint32_t mem_size;
+    uint32_t mem_pos;
+
+    // Output batching
+    uint16_t *band;
+    uint16_t band_y;                // Image line at the top of the band
+    uint16_t batch_lines;           // Whole MCU rows per band
+    frame_jpeg_flush_fn flush;
+    void *ctx;
+
+    JDEC jdec;
+    uint8_t work[FRAME_JPEG_WORK_SIZE] __attribute__((aligned(4)));
+};
+
+/**
+ * @brief Open a JPEG file and parse its headers
+ * @param jpeg Decoder state to initialize
+ * @param path Full VFS path (e.g. "/sdcard/nyan_bg.jpg")
+ * @return true on success, false on failure or unsupported JPEG
+ */
+bool frame_jpeg_open(frame_jpeg_t *jpeg, const char *path);
+
+/**
+ * @brief Open a JPEG held in memory (e.g. embedded in flash)
+ * @return true on success, false on failure or unsupported JPEG
+ */
+bool frame_jpeg_open_mem(frame_jpeg_t *jpeg, const uint8_t *data, uint32_t size);
+
+/**
+ * @brief Check for the JPEG start-of-image marker
+ */
+static inline bool frame_jpeg_is_jpeg(const uint8_t *data, uint32_t size) {
+    return size >= 2 && data[0] == 0xFF && data[1] == 0xD8;
+}
+
+/**
+ * @brief Decode the whole image band by band
+ * @param jpeg Open decoder
+ * @param band First band buffer, jpeg->width * band_lines pixels
+ * @param band_lines Band height (at least jpeg->mcu_lines; rounded down to whole MCU rows)
+ * @param flush Called for every filled band
+ * @param ctx Passed to flush
+ * @return true if the image was decoded completely
+ */
+bool frame_jpeg_decode(frame_jpeg_t *jpeg, uint16_t *band, uint16_t band_lines,
+                       frame_jpeg_flush_fn flush, void *ctx);
+
+/**
+ * @brief Close the source file (if any)
+ */
+void frame_jpeg_close(frame_jpeg_t *jpeg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FRAME_JPEG_H
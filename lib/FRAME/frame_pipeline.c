@@ -0,0 +1,339 @@
+#include "frame_pipeline.h"
+#include "frame_stream.h"
+#include "frame_jpeg.h"
+#include "dma_buf.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "FRAME_PIPE";
+
+// Lock-free SPSC ring: head is written only by the reader, tail only by the display
+typedef struct {
+    frame_chunk_t chunks[FRAME_PIPELINE_SLOTS];
+    uint16_t *buffers[FRAME_PIPELINE_SLOTS];  // DMA-capable band buffers (data of bufs)
+    dma_buf_t *bufs[FRAME_PIPELINE_SLOTS];
+    atomic_uint head;                         // Free-running, next slot to fill
+    atomic_uint tail;                         // Free-running, next slot to display
+} frame_ring_t;
+
+static frame_ring_t ring;
+static frame_pipeline_config_t pipe_config;
+static frame_stream_t pipe_stream;  // Only touched by the reader task
+static frame_jpeg_t pipe_jpeg;
+static uint32_t jpeg_missing;       // Bit per frame: no usable JPEG variant on the card
+
+// JPEG band hand-off state
+typedef struct {
+    uint8_t frame;
+    frame_chunk_t *chunk;            // Acquired slot for the band being decoded
+    uint16_t *slot;                  // Cache slot the frame decodes into (or NULL)
+} jpeg_queue_t;
+
+static TaskHandle_t reader_task = NULL;
+static TaskHandle_t display_task = NULL;
+static atomic_bool stop_requested;
+static atomic_bool reader_done;
+static atomic_uint requested_frame;
+
+// Wait until the ring has a free slot; NULL when stopping
+static frame_chunk_t *ring_acquire(uint16_t **buffer) {
+    while (!atomic_load(&stop_requested)) {
+        uint32_t head = atomic_load_explicit(&ring.head, memory_order_relaxed);
+        uint32_t tail = atomic_load_explicit(&ring.tail, memory_order_acquire);
+        if (head - tail < FRAME_PIPELINE_SLOTS) {
+            *buffer = ring.buffers[head % FRAME_PIPELINE_SLOTS];
+            return &ring.chunks[head % FRAME_PIPELINE_SLOTS];
+        }
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));  // Woken by frame_pipeline_release()
+    }
+    return NULL;
+}
+
+// Publish the acquired slot to the display side
+static void ring_commit(void) {
+    atomic_fetch_add_explicit(&ring.head, 1, memory_order_release);
+    TaskHandle_t consumer = display_task;
+    if (consumer != NULL) {
+        xTaskNotifyGive(consumer);
+    }
+}
+
+static bool push_error(uint8_t frame) {
+    uint16_t *buffer;
+    frame_chunk_t *chunk = ring_acquire(&buffer);
+    if (chunk == NULL) {
+        return false;
+    }
+    memset(chunk, 0, sizeof(frame_chunk_t));
+    chunk->frame = frame;
+    chunk->flags = FRAME_CHUNK_ERROR;
+    ring_commit();
+    return true;
+}
+
+// Queue a frame that is already decoded in PSRAM
+static bool queue_cached(uint8_t frame, const uint16_t *pixels) {
+    for (uint16_t y = 0; y < pipe_config.height; y += pipe_config.band_lines) {
+        uint16_t *buffer;
+        frame_chunk_t *chunk = ring_acquire(&buffer);
+        if (chunk == NULL) {
+            return false;
+        }
+        chunk->pixels = pixels + (uint32_t)y * pipe_config.width;
+        chunk->y = y;
+        chunk->lines = pipe_config.band_lines;
+        chunk->frame = frame;
+        chunk->flags = 0;
+        chunk->duration_ms = pipe_config.cache->durations[frame];
+        ring_commit();
+    }
+    return true;
+}
+
+// Read one frame from SD into ring buffers (or straight into its cache slot)
+static bool queue_streamed(uint8_t frame) {
+    char path[64];
+    snprintf(path, sizeof(path), pipe_config.path_fmt, frame);
+    if (!frame_stream_open(&pipe_stream, path)) {
+        return push_error(frame);
+    }
+
+    frame_cache_t *cache = pipe_config.cache;
+    bool fits = pipe_stream.header.width == pipe_config.width && pipe_stream.header.height == pipe_config.height;
+    uint16_t *slot = (cache != NULL && fits) ? frame_cache_reserve(cache, frame) : NULL;
+    bool ok = fits;
+
+    for (uint16_t y = 0; ok && y < pipe_config.height; y += pipe_config.band_lines) {
+        uint16_t *buffer;
+        frame_chunk_t *chunk = ring_acquire(&buffer);
+        if (chunk == NULL) {
+            frame_stream_close(&pipe_stream);
+            return false;
+        }
+
+        uint16_t *dst = slot ? slot + (uint32_t)y * pipe_config.width : buffer;
+        if (!frame_stream_read_lines(&pipe_stream, dst, pipe_config.band_lines)) {
+            ESP_LOGE(TAG, "Failed to read %s at line %d", path, y);
+            ok = false;
+            break;
+        }
+
+        chunk->pixels = dst;
+        chunk->y = y;
+        chunk->lines = pipe_config.band_lines;
+        chunk->frame = frame;
+        chunk->flags = 0;
+        chunk->duration_ms = pipe_stream.header.duration_ms;
+        ring_commit();
+    }
+
+    // Codec and format are picked per asset from the frame header
+    static bool format_logged = false;
+    if (!format_logged && ok) {
+        format_logged = true;
+        ESP_LOGI(TAG, "Frame format %d, codec %d: %lu bytes read from SD for %lu encoded bytes",
+                 pipe_stream.header.format, pipe_stream.header.codec,
+                 (unsigned long)pipe_stream.bytes_in,
+                 (unsigned long)frame_stream_frame_bytes(&pipe_stream));
+    }
+
+    if (slot != NULL) {
+        cache->durations[frame] = pipe_stream.header.duration_ms;
+        frame_cache_commit(cache, frame, ok);
+    }
+    frame_stream_close(&pipe_stream);
+    return ok ? true : push_error(frame);
+}
+
+// Commit a decoded JPEG band and return the buffer for the next one
+static uint16_t *jpeg_flush(void *ctx, const frame_jpeg_t *jpeg, uint16_t y, uint16_t lines, uint16_t *pixels) {
+    jpeg_queue_t *queue = (jpeg_queue_t *)ctx;
+
+    queue->chunk->pixels = pixels;
+    queue->chunk->y = y;
+    queue->chunk->lines = lines;
+    queue->chunk->frame = queue->frame;
+    queue->chunk->flags = 0;
+    queue->chunk->duration_ms = 0;  // JPEG carries no frame duration
+    ring_commit();
+
+    if (y + lines >= jpeg->height) {
+        return pixels;  // Last band, nothing more will be written
+    }
+
+    uint16_t *buffer;
+    queue->chunk = ring_acquire(&buffer);
+    if (queue->chunk == NULL) {
+        return NULL;
+    }
+    return queue->slot ? pixels + (uint32_t)lines * jpeg->width : buffer;
+}
+
+// Decode one JPEG frame from SD; falls back to the NYF1 asset if there is none
+static bool queue_jpeg(uint8_t frame) {
+    char path[64];
+    snprintf(path, sizeof(path), pipe_config.jpeg_path_fmt, frame);
+    if (!frame_jpeg_open(&pipe_jpeg, path)) {
+        jpeg_missing |= 1u << frame;
+        return queue_streamed(frame);
+    }
+    if (pipe_jpeg.width != pipe_config.width || pipe_jpeg.height != pipe_config.height) {
+        ESP_LOGE(TAG, "%s is %dx%d, expected %dx%d", path, pipe_jpeg.width, pipe_jpeg.height,
+                 pipe_config.width, pipe_config.height);
+        frame_jpeg_close(&pipe_jpeg);
+        return push_error(frame);
+    }
+
+    frame_cache_t *cache = pipe_config.cache;
+    jpeg_queue_t queue = {
+        .frame = frame,
+        .slot = cache ? frame_cache_reserve(cache, frame) : NULL
+    };
+
+    uint16_t *buffer;
+    queue.chunk = ring_acquire(&buffer);
+    if (queue.chunk == NULL) {
+        frame_jpeg_close(&pipe_jpeg);
+        return false;
+    }
+
+    bool ok = frame_jpeg_decode(&pipe_jpeg, queue.slot ? queue.slot : buffer, pipe_config.band_lines,
+                                jpeg_flush, &queue);
+    frame_jpeg_close(&pipe_jpeg);
+
+    if (queue.slot != NULL) {
+        cache->durations[frame] = 0;
+        frame_cache_commit(cache, frame, ok);
+    }
+    if (!ok && atomic_load(&stop_requested)) {
+        return false;
+    }
+    return ok ? true : push_error(frame);
+}
+
+static void reader_task_fn(void *arg) {
+    (void)arg;
+    uint8_t frame = atomic_load(&requested_frame);
+
+    while (!atomic_load(&stop_requested)) {
+        const uint16_t *cached = pipe_config.cache ? frame_cache_lookup(pipe_config.cache, frame) : NULL;
+        bool use_jpeg = pipe_config.jpeg_path_fmt != NULL && !(jpeg_missing & (1u << frame));
+        bool queued;
+        if (cached) {
+            queued = queue_cached(frame, cached);
+        } else if (use_jpeg) {
+            queued = queue_jpeg(frame);
+        } else {
+            queued = queue_streamed(frame);
+        }
+        if (!queued && atomic_load(&stop_requested)) {
+            break;
+        }
+
+        // Follow the display if it skipped ahead, otherwise read the next frame
+        uint8_t wanted = atomic_load(&requested_frame);
+        frame = (wanted != frame) ? wanted : (frame + 1) % pipe_config.frame_count;
+    }
+
+    atomic_store(&reader_done, true);
+    vTaskDelete(NULL);
+}
+
+bool frame_pipeline_start(const frame_pipeline_config_t *config) {
+    if (reader_task != NULL) {
+        return true;
+    }
+    if (!config || !config->path_fmt || config->frame_count == 0 || config->frame_count > 32 ||
+        config->band_lines == 0 ||
+        config->height % config->band_lines != 0) {
+        return false;
+    }
+
+    pipe_config = *config;
+    memset(&ring, 0, sizeof(ring));
+    jpeg_missing = 0;
+
+    size_t buffer_bytes = (size_t)config->width * config->band_lines * sizeof(uint16_t);
+    for (int i = 0; i < FRAME_PIPELINE_SLOTS; i++) {
+        // SD reads land here and go to the panel from the same memory
+        ring.bufs[i] = dma_buf_alloc(buffer_bytes, "frame_ring");
+        ring.buffers[i] = dma_buf_data(ring.bufs[i]);
+        if (ring.buffers[i] == NULL) {
+            ESP_LOGE(TAG, "Failed to allocate chunk buffer %d (%u bytes)", i, (unsigned)buffer_bytes);
+            frame_pipeline_stop();
+            return false;
+        }
+    }
+
+    atomic_store(&stop_requested, false);
+    atomic_store(&reader_done, false);
+    display_task = NULL;
+
+    if (xTaskCreatePinnedToCore(reader_task_fn, "frame_reader", FRAME_PIPELINE_STACK_SIZE, NULL,
+                                FRAME_PIPELINE_PRIORITY, &reader_task, FRAME_PIPELINE_CORE) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create reader task");
+        reader_task = NULL;
+        frame_pipeline_stop();
+        return false;
+    }
+
+    ESP_LOGI(TAG, "Reader started on core %d: %d x %u byte chunk buffers",
+             FRAME_PIPELINE_CORE, FRAME_PIPELINE_SLOTS, (unsigned)buffer_bytes);
+    return true;
+}
+
+void frame_pipeline_stop(void) {
+    if (reader_task != NULL) {
+        atomic_store(&stop_requested, true);
+        xTaskNotifyGive(reader_task);
+        while (!atomic_load(&reader_done)) {
+            vTaskDelay(pdMS_TO_TICKS(10));
+        }
+        reader_task = NULL;
+    }
+
+    for (int i = 0; i < FRAME_PIPELINE_SLOTS; i++) {
+        dma_buf_unref(ring.bufs[i]);
+        ring.bufs[i] = NULL;
+        ring.buffers[i] = NULL;
+    }
+    display_task = NULL;
+}
+
+bool frame_pipeline_running(void) {
+    return reader_task != NULL;
+}
+
+void frame_pipeline_request_frame(uint8_t frame) {
+    atomic_store(&requested_frame, frame);
+}
+
+bool frame_pipeline_peek(frame_chunk_t *chunk, TickType_t timeout) {
+    display_task = xTaskGetCurrentTaskHandle();
+
+    TickType_t start = xTaskGetTickCount();
+    for (;;) {
+        uint32_t tail = atomic_load_explicit(&ring.tail, memory_order_relaxed);
+        uint32_t head = atomic_load_explicit(&ring.head, memory_order_acquire);
+        if (head != tail) {
+            *chunk = ring.chunks[tail % FRAME_PIPELINE_SLOTS];
+            return true;
+        }
+
+        TickType_t waited = xTaskGetTickCount() - start;
+        if (waited >= timeout) {
+            return false;
+        }
+        ulTaskNotifyTake(pdTRUE, timeout - waited);  // Woken by ring_commit()
+    }
+}
+
+void frame_pipeline_release(void) {
+    atomic_fetch_add_explicit(&ring.tail, 1, memory_order_release);
+    if (reader_task != NULL) {
+        xTaskNotifyGive(reader_task);
+    }
+}
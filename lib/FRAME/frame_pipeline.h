@@ -0,0 +1,103 @@
+#ifndef FRAME_PIPELINE_H
+#define FRAME_PIPELINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "frame_cache.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Cross-core frame pipeline
+ *
+ * A reader task (pinned to the SD core) decodes animation frames band by
+ * band into a ring of DMA-capable chunk buffers. The display side pops
+ * chunks and sends them to the panel, so SD reads and SPI writes overlap and
+ * a frame takes max(read, write) instead of their sum.
+ *
+ * The ring is a single-producer / single-consumer queue: the reader only
+ * advances head, the display only advances tail, and neither takes a lock.
+ * Task notifications wake the other side when the ring goes non-empty or
+ * non-full.
+ *
+ * Frames may be NYF1 assets or baseline JPEGs (decoded with the ROM TJpgDec,
+ * see frame_jpeg.h); JPEG bands are whole MCU rows, so chunk heights vary.
+ *
+ * When a frame cache is given, cached frames are queued as pointers into
+ * PSRAM without touching the card, and missed frames are decoded straight
+ * into their cache slot.
+ */
+
+#define FRAME_PIPELINE_SLOTS       3     // Chunk buffers in the ring (3 x 25,600 bytes at 40 lines)
+#define FRAME_PIPELINE_CORE        0     // Reader task core (display runs on the other)
+#define FRAME_PIPELINE_PRIORITY    4
+#define FRAME_PIPELINE_STACK_SIZE  4096
+
+// Chunk flags
+#define FRAME_CHUNK_ERROR  0x01  // Frame could not be read; no pixels
+
+typedef struct {
+    const uint16_t *pixels;  // Ring buffer or PSRAM cache memory
+    uint16_t y;              // First line of the chunk
+    uint16_t lines;
+    uint8_t frame;           // Animation frame this chunk belongs to
+    uint8_t flags;
+    uint16_t duration_ms;    // Frame duration from the asset header (0 = unknown)
+} frame_chunk_t;
+
+typedef struct {
+    const char *path_fmt;    // printf pattern taking the frame index, e.g. "/sdcard/nyan_%d.raw"
+    const char *jpeg_path_fmt; // Optional JPEG variant tried first, e.g. "/sdcard/nyan_%d.jpg"
+    uint8_t frame_count;
+    uint16_t width;          // Expected frame size (frames are band_lines-aligned)
+    uint16_t height;
+    uint16_t band_lines;
+    frame_cache_t *cache;    // Optional PSRAM cache (NULL to always stream)
+} frame_pipeline_config_t;
+
+/**
+ * @brief Allocate the chunk ring and start the reader task
+ * @param config Pipeline configuration (copied)
+ * @return true on success, false on failure
+ */
+bool frame_pipeline_start(const frame_pipeline_config_t *config);
+
+/**
+ * @brief Stop the reader task and free the chunk ring
+ */
+void frame_pipeline_stop(void);
+
+/**
+ * @brief Whether the reader task is running
+ */
+bool frame_pipeline_running(void);
+
+/**
+ * @brief Tell the reader which frame the display needs next
+ *
+ * Chunks already queued for other frames are still delivered; the consumer
+ * drops them by checking frame_chunk_t.frame.
+ */
+void frame_pipeline_request_frame(uint8_t frame);
+
+/**
+ * @brief Wait for the next chunk (consumer side)
+ * @param chunk Filled with the oldest queued chunk
+ * @param timeout Maximum time to wait
+ * @return true if a chunk is available; release it with frame_pipeline_release()
+ */
+bool frame_pipeline_peek(frame_chunk_t *chunk, TickType_t timeout);
+
+/**
+ * @brief Return the chunk from frame_pipeline_peek() to the reader
+ */
+void frame_pipeline_release(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FRAME_PIPELINE_H
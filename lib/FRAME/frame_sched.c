@@ -0,0 +1,61 @@
+#include "frame_sched.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include <string.h>
+
+static const char *TAG = "FRAME_SCHED";
+
+// Resynchronize instead of dropping when this many frames behind (e.g. after a stall)
+#define FRAME_SCHED_MAX_SKIP  8
+
+void frame_sched_reset(frame_sched_t *sched) {
+    if (sched) {
+        memset(sched, 0, sizeof(frame_sched_t));
+    }
+}
+
+uint32_t frame_sched_wait(frame_sched_t *sched, uint32_t duration_ms) {
+    int64_t now = esp_timer_get_time();
+    int64_t duration_us = (int64_t)duration_ms * 1000;
+
+    // First frame defines the timeline
+    if (!sched->started) {
+        sched->started = true;
+        sched->next_due_us = now;
+    }
+
+    int64_t slot_end = sched->next_due_us + duration_us;
+    if (now <= slot_end) {
+        sched->on_time++;
+    } else {
+        sched->late++;
+    }
+    sched->next_due_us = slot_end;
+
+    if (now < sched->next_due_us) {
+        // Ahead: release the CPU until the next deadline (rounded up to a tick)
+        int64_t tick_us = (int64_t)portTICK_PERIOD_MS * 1000;
+        TickType_t ticks = (TickType_t)((sched->next_due_us - now + tick_us - 1) / tick_us);
+        vTaskDelay(ticks);
+        return 1;
+    }
+
+    // Behind: skip every frame whose slot has already ended
+    uint32_t skip = duration_us > 0 ? (uint32_t)((now - sched->next_due_us) / duration_us) : 0;
+    if (skip > FRAME_SCHED_MAX_SKIP) {
+        sched->next_due_us = now;
+        return 1;
+    }
+    sched->dropped += skip;
+    sched->next_due_us += skip * duration_us;
+    return 1 + skip;
+}
+
+void frame_sched_log_stats(const frame_sched_t *sched, const char *name) {
+    uint32_t shown = sched->on_time + sched->late;
+    ESP_LOGI(TAG, "%s: %lu frames shown (%lu on time, %lu late), %lu dropped",
+             name, (unsigned long)shown, (unsigned long)sched->on_time,
+             (unsigned long)sched->late, (unsigned long)sched->dropped);
+}
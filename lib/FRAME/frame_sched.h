@@ -0,0 +1,54 @@
+#ifndef FRAME_SCHED_H
+#define FRAME_SCHED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Fixed-timestep frame scheduler
+ *
+ * Frame N is due at start + sum of the durations before it, so playback
+ * speed does not depend on how long a frame takes to read and draw. When a
+ * frame finishes early the task sleeps until the next deadline; when it
+ * finishes late, frames whose whole slot has already passed are skipped.
+ */
+
+typedef struct {
+    int64_t next_due_us;   // Deadline for the next frame to be shown
+    bool started;
+    uint32_t on_time;      // Drawn within their slot
+    uint32_t late;         // Drawn, but finished after their slot ended
+    uint32_t dropped;      // Skipped to catch up
+} frame_sched_t;
+
+/**
+ * @brief Reset deadlines and counters (call when playback starts)
+ */
+void frame_sched_reset(frame_sched_t *sched);
+
+/**
+ * @brief Finish the frame just drawn and wait for the next deadline
+ *
+ * Sleeps the calling task when ahead of schedule. When behind, returns
+ * immediately and counts the frames that have to be skipped.
+ *
+ * @param sched Scheduler state
+ * @param duration_ms Display time of the frame just drawn
+ * @return Frames to advance (1, or more when frames were dropped)
+ */
+uint32_t frame_sched_wait(frame_sched_t *sched, uint32_t duration_ms);
+
+/**
+ * @brief Log on-time / late / dropped counters
+ */
+void frame_sched_log_stats(const frame_sched_t *sched, const char *name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FRAME_SCHED_H
@@ -0,0 +1,222 @@
+#include "frame_stream.h"
+#include "frame_decode.h"
+#include "esp_log.h"
+#include <string.h>
+
+static const char *TAG = "FRAME";
+
+// Read raw stored bytes from the file or memory source
+static size_t stream_read(frame_stream_t *stream, uint8_t *buf, size_t len) {
+#ifdef ESP_PLATFORM
+    if (stream->raw_open) {
+        uint32_t got = sd_raw_read(&stream->raw, stream->raw_pos, buf, len);
+        stream->raw_pos += got;
+        return got;
+    }
+#endif
+    if (stream->file != NULL) {
+        return fread(buf, 1, len, stream->file);
+    }
+    uint32_t left = stream->mem_size - stream->mem_pos;
+    if (len > left) {
+        len = left;
+    }
+    memcpy(buf, stream->mem + stream->mem_pos, len);
+    stream->mem_pos += len;
+    return len;
+}
+
+// Input ring refill callback
+static size_t stream_fill(void *ctx, uint8_t *buf, size_t len) {
+    return stream_read((frame_stream_t *)ctx, buf, len);
+}
+
+// Parse header and palette from the current source position
+static bool stream_parse(frame_stream_t *stream, const char *name) {
+    frame_header_t hdr;
+    size_t got = stream_read(stream, (uint8_t *)&hdr, sizeof(hdr));
+
+    if (got == sizeof(hdr) && memcmp(hdr.magic, FRAME_MAGIC, FRAME_MAGIC_LEN) == 0) {
+        if (!frame_header_is_valid(&hdr)) {
+            ESP_LOGE(TAG, "Invalid frame header in %s (fmt=%d, codec=%d, %dx%d, pal=%d)",
+                     name, hdr.format, hdr.codec, hdr.width, hdr.height, hdr.palette_size);
+            return false;
+        }
+
+        if (hdr.palette_size > 0) {
+            size_t pal_bytes = hdr.palette_size * sizeof(uint16_t);
+            if (stream_read(stream, (uint8_t *)stream->palette, pal_bytes) != pal_bytes) {
+                ESP_LOGE(TAG, "Truncated palette in %s", name);
+                return false;
+            }
+        }
+
+        if (hdr.format == FRAME_FMT_INDEX4) {
+            frame_build_pair_lut(stream->palette, hdr.palette_size, stream->pair_lut);
+        }
+
+        stream->header = hdr;
+        stream->data_offset = sizeof(hdr) + hdr.palette_size * sizeof(uint16_t);
+    } else {
+        // Legacy headerless RGB565 frame
+        memcpy(stream->header.magic, FRAME_MAGIC, FRAME_MAGIC_LEN);
+        stream->header.width = FRAME_LEGACY_WIDTH;
+        stream->header.height = FRAME_LEGACY_HEIGHT;
+        stream->header.format = FRAME_FMT_RGB565;
+        stream->header.codec = FRAME_CODEC_NONE;
+        stream->data_offset = 0;
+    }
+
+    stream->line_bytes = frame_line_bytes(stream->header.format, stream->header.width);
+    return true;
+}
+
+bool frame_stream_open(frame_stream_t *stream, const char *path) {
+    if (!stream || !path) {
+        return false;
+    }
+
+    memset(stream, 0, sizeof(frame_stream_t));
+
+#ifdef ESP_PLATFORM
+    // Raw sectors skip stdio/VFS/FATFS on every band read
+    stream->raw_open = sd_raw_open(&stream->raw, path);
+#endif
+    if (!stream->raw_open) {
+        stream->file = fopen(path, "rb");
+    }
+    if (!stream->raw_open && stream->file == NULL) {
+        ESP_LOGE(TAG, "Failed to open file: %s", path);
+        return false;
+    }
+
+    if (!stream_parse(stream, path)) {
+        frame_stream_close(stream);
+        return false;
+    }
+
+    return frame_stream_rewind(stream);
+}
+
+bool frame_stream_open_mem(frame_stream_t *stream, const uint8_t *data, uint32_t size) {
+    if (!stream || !data) {
+        return false;
+    }
+
+    memset(stream, 0, sizeof(frame_stream_t));
+    stream->mem = data;
+    stream->mem_size = size;
+
+    if (!stream_parse(stream, "<memory>")) {
+        return false;
+    }
+
+    return frame_stream_rewind(stream);
+}
+
+bool frame_stream_rewind(frame_stream_t *stream) {
+    if (!stream || (!stream->raw_open && stream->file == NULL && stream->mem == NULL)) {
+        return false;
+    }
+
+    stream->next_line = 0;
+    stream->bytes_in = 0;
+    frame_src_init(&stream->src, stream_fill, stream);
+
+#ifdef ESP_PLATFORM
+    if (stream->raw_open) {
+        stream->raw_pos = stream->data_offset;
+        return stream->raw_pos <= stream->raw.size;
+    }
+#endif
+    if (stream->file != NULL) {
+        return fseek(stream->file, stream->data_offset, SEEK_SET) == 0;
+    }
+    stream->mem_pos = stream->data_offset;
+    return stream->mem_pos <= stream->mem_size;
+}
+
+// Decompress one band of encoded pixel data into buf
+static bool stream_read_band(frame_stream_t *stream, uint8_t *buf, uint32_t out_bytes) {
+    uint8_t size_buf[4];
+    if (!frame_src_read(&stream->src, size_buf, sizeof(size_buf))) {
+        return false;
+    }
+    uint32_t in_bytes = size_buf[0] | (size_buf[1] << 8) | (size_buf[2] << 16) | ((uint32_t)size_buf[3] << 24);
+    stream->bytes_in += sizeof(size_buf) + in_bytes;
+
+    if (stream->header.codec == FRAME_CODEC_RLE) {
+        uint8_t elem = (stream->header.format == FRAME_FMT_RGB565) ? 2 : 1;
+        return frame_rle_decode(&stream->src, in_bytes, buf, out_bytes, elem);
+    }
+    return frame_lz4_decode(&stream->src, in_bytes, buf, out_bytes);
+}
+
+bool frame_stream_read_lines(frame_stream_t *stream, uint16_t *dst, uint16_t lines) {
+    if (!stream || (!stream->raw_open && stream->file == NULL && stream->mem == NULL) || !dst) {
+        return false;
+    }
+    if (stream->next_line + lines > stream->header.height) {
+        return false;
+    }
+
+    uint32_t pixels = (uint32_t)stream->header.width * lines;
+    uint32_t in_bytes = stream->line_bytes * lines;
+
+    // Indexed data is decoded into the tail of the output buffer and expanded
+    // forward in place, so no separate staging buffer is needed.
+    uint8_t *in = (uint8_t *)dst + pixels * sizeof(uint16_t) - in_bytes;
+
+    if (stream->header.codec == FRAME_CODEC_NONE) {
+        if (stream_read(stream, in, in_bytes) != in_bytes) {
+            return false;
+        }
+        stream->bytes_in += in_bytes;
+    } else {
+        // Bands are independent blocks - callers must read whole bands
+        uint16_t band = stream->header.band_lines;
+        uint16_t left = stream->header.height - stream->next_line;
+        if (lines != (left < band ? left : band)) {
+            ESP_LOGE(TAG, "Read of %d lines does not match %d-line bands", lines, band);
+            return false;
+        }
+        if (!stream_read_band(stream, in, in_bytes)) {
+            ESP_LOGE(TAG, "Corrupt band at line %d", stream->next_line);
+            return false;
+        }
+    }
+
+    switch (stream->header.format) {
+        case FRAME_FMT_INDEX8:
+            frame_expand_index8(in, dst, pixels, stream->palette);
+            break;
+        case FRAME_FMT_INDEX4:
+            frame_expand_index4(in, dst, pixels, stream->pair_lut);
+            break;
+        default:
+            break;  // RGB565 was decoded straight into dst
+    }
+
+    stream->next_line += lines;
+    return true;
+}
+
+uint32_t frame_stream_frame_bytes(const frame_stream_t *stream) {
+    return stream->line_bytes * stream->header.height;
+}
+
+void frame_stream_close(frame_stream_t *stream) {
+#ifdef ESP_PLATFORM
+    if (stream && stream->raw_open) {
+        sd_raw_close(&stream->raw);
+        stream->raw_open = false;
+    }
+#endif
+    if (stream && stream->file != NULL) {
+        fclose(stream->file);
+        stream->file = NULL;
+    }
+    if (stream) {
+        stream->mem = NULL;
+    }
+}
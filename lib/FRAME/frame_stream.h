@@ -0,0 +1,91 @@
+#ifndef FRAME_STREAM_H
+#define FRAME_STREAM_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "frame_format.h"
+#include "frame_codec.h"
+#ifdef ESP_PLATFORM
+#include "sd_raw.h"     // Not used by the host tools (tools/bench)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Open frame asset being streamed band by band into RGB565 buffers
+typedef struct {
+    FILE *file;                            // stdio file source (fallback)
+#ifdef ESP_PLATFORM
+    sd_raw_file_t raw;                     // Raw-sector file source (preferred on SD)
+    uint32_t raw_pos;
+#endif
+    bool raw_open;
+    const uint8_t *mem;                    // Memory source (flash/RAM blob)
+    uint32_t mem_size;
+    uint32_t mem_pos;
+    frame_header_t header;
+    uint32_t data_offset;                  // Offset of the first pixel/band byte
+    uint32_t line_bytes;                   // Encoded bytes per line
+    uint16_t next_line;                    // Next line to be decoded
+    uint32_t bytes_in;                     // Stored bytes consumed this frame
+    uint16_t palette[FRAME_MAX_PALETTE];   // Panel-ready palette (indexed formats)
+    uint32_t pair_lut[256];                // 4 bpp pixel-pair table
+    frame_src_t src;                       // Input ring for compressed bands
+} frame_stream_t;
+
+/**
+ * @brief Open a frame asset and parse its header/palette
+ * @param stream Stream state to initialize
+ * Files on the SD card are read as raw sectors (see sd_raw.h) when their
+ * cluster chain can be mapped; otherwise they are read through stdio.
+ *
+ * @param path Full VFS path (e.g. "/sdcard/nyan_0.raw")
+ * @return true on success, false on failure
+ */
+bool frame_stream_open(frame_stream_t *stream, const char *path);
+
+/**
+ * @brief Open a frame asset held in memory (e.g. embedded in flash)
+ * @param stream Stream state to initialize
+ * @param data Asset bytes, starting with the NYF1 header
+ * @param size Asset size in bytes
+ * @return true on success, false on failure
+ */
+bool frame_stream_open_mem(frame_stream_t *stream, const uint8_t *data, uint32_t size);
+
+/**
+ * @brief Seek back to the first line of the frame
+ * @return true on success, false on failure
+ */
+bool frame_stream_rewind(frame_stream_t *stream);
+
+/**
+ * @brief Decode the next lines of the frame into an RGB565 buffer
+ *
+ * For compressed assets, lines must equal header.band_lines (except for a
+ * shorter final band) since each band is an independent block.
+ *
+ * @param stream Open stream
+ * @param dst Output buffer, at least width * lines pixels, 4-byte aligned
+ * @param lines Number of lines to decode
+ * @return true if all lines were read and decoded
+ */
+bool frame_stream_read_lines(frame_stream_t *stream, uint16_t *dst, uint16_t lines);
+
+/**
+ * @brief Encoded bytes per full frame before compression
+ */
+uint32_t frame_stream_frame_bytes(const frame_stream_t *stream);
+
+/**
+ * @brief Close the stream
+ */
+void frame_stream_close(frame_stream_t *stream);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FRAME_STREAM_H
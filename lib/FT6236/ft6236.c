@@ -1,9 +1,11 @@
 #include "ft6236.h"
-#include "driver/i2c.h"
+#include "driver/i2c_master.h"
 #include "driver/gpio.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
 #include <string.h>
 
 static const char *TAG = "FT6236";
@@ -11,6 +13,18 @@ static const char *TAG = "FT6236";
 static ft6236_config_t touch_config;
 static bool initialized = false;
 
+static i2c_master_bus_handle_t touch_bus = NULL;
+static i2c_master_dev_handle_t touch_dev = NULL;
+
+// Transfer buffers and their lock live for the driver's lifetime; polling never touches the heap
+static uint8_t rx_buf[FT6236_REPORT_SIZE];
+static uint8_t tx_buf[2];
+static StaticSemaphore_t xfer_lock_storage;
+static SemaphoreHandle_t xfer_lock = NULL;
+
+#define FT6236_I2C_TIMEOUT_MS   20
+#define FT6236_READY_TIMEOUT_US 300000  // Controller power-on time (datasheet: up to 300 ms)
+
 // FT6236 Register addresses
 #define FT6236_REG_MODE         0x00
 #define FT6236_REG_GEST_ID      0x01
@@ -23,6 +37,11 @@ static bool initialized = false;
 #define FT6236_REG_TOUCH2_XL    0x0A
 #define FT6236_REG_TOUCH2_YH    0x0B
 #define FT6236_REG_TOUCH2_YL    0x0C
+#define FT6236_REG_G_CTRL       0x86    // 1 = switch to monitor mode when idle
+#define FT6236_REG_TIME_MONITOR 0x87
+#define FT6236_REG_RATE_ACTIVE  0x88
+#define FT6236_REG_RATE_MONITOR 0x89
+#define FT6236_REG_G_MODE       0xA4    // 0 = INT held while touched, 1 = INT pulse per report
 
 // Touch events
 #define FT6236_EVENT_PRESS_DOWN   0
@@ -35,27 +54,8 @@ static esp_err_t ft6236_i2c_read(uint8_t reg, uint8_t *data, size_t len) {
         return ESP_ERR_INVALID_ARG;
     }
     
-    i2c_cmd_handle_t cmd = i2c_cmd_link_create();
-    
-    // Start + Write device address + register address
-    i2c_master_start(cmd);
-    i2c_master_write_byte(cmd, (FT6236_ADDR << 1) | I2C_MASTER_WRITE, true);
-    i2c_master_write_byte(cmd, reg, true);
-    
-    // Repeated start + Read data
-    i2c_master_start(cmd);
-    i2c_master_write_byte(cmd, (FT6236_ADDR << 1) | I2C_MASTER_READ, true);
-    
-    if (len > 1) {
-        i2c_master_read(cmd, data, len - 1, I2C_MASTER_ACK);
-    }
-    i2c_master_read_byte(cmd, data + len - 1, I2C_MASTER_NACK);
-    i2c_master_stop(cmd);
-    
-    esp_err_t ret = i2c_master_cmd_begin(touch_config.i2c_port, cmd, pdMS_TO_TICKS(100));
-    i2c_cmd_link_delete(cmd);
-    
-    return ret;
+    // Register address write + repeated start + read, on the persistent device handle
+    return i2c_master_transmit_receive(touch_dev, &reg, 1, data, len, FT6236_I2C_TIMEOUT_MS);
 }
 
 static esp_err_t ft6236_i2c_write(uint8_t reg, uint8_t data) {
@@ -63,18 +63,23 @@ static esp_err_t ft6236_i2c_write(uint8_t reg, uint8_t data) {
         return ESP_ERR_INVALID_STATE;
     }
     
-    i2c_cmd_handle_t cmd = i2c_cmd_link_create();
-    
-    i2c_master_start(cmd);
-    i2c_master_write_byte(cmd, (FT6236_ADDR << 1) | I2C_MASTER_WRITE, true);
-    i2c_master_write_byte(cmd, reg, true);
-    i2c_master_write_byte(cmd, data, true);
-    i2c_master_stop(cmd);
-    
-    esp_err_t ret = i2c_master_cmd_begin(touch_config.i2c_port, cmd, pdMS_TO_TICKS(100));
-    i2c_cmd_link_delete(cmd);
+    tx_buf[0] = reg;
+    tx_buf[1] = data;
+    return i2c_master_transmit(touch_dev, tx_buf, sizeof(tx_buf), FT6236_I2C_TIMEOUT_MS);
+}
+
+static esp_err_t add_device(uint32_t freq) {
+    if (touch_dev != NULL) {
+        i2c_master_bus_rm_device(touch_dev);
+        touch_dev = NULL;
+    }
     
-    return ret;
+    i2c_device_config_t dev_conf = {
+        .dev_addr_length = I2C_ADDR_BIT_LEN_7,
+        .device_address = FT6236_ADDR,
+        .scl_speed_hz = freq,
+    };
+    return i2c_master_bus_add_device(touch_bus, &dev_conf, &touch_dev);
 }
 
 bool ft6236_init(const ft6236_config_t *config) {
@@ -84,26 +89,33 @@ bool ft6236_init(const ft6236_config_t *config) {
     }
     
     memcpy(&touch_config, config, sizeof(ft6236_config_t));
+    xfer_lock = xSemaphoreCreateMutexStatic(&xfer_lock_storage);
     
-    // Configure I2C
-    i2c_config_t i2c_conf = {
-        .mode = I2C_MODE_MASTER,
+    // Configure the I2C bus once; the device handle is reused by every read
+    i2c_master_bus_config_t bus_conf = {
+        .i2c_port = config->i2c_port,
         .sda_io_num = config->pin_sda,
         .scl_io_num = config->pin_scl,
-        .sda_pullup_en = GPIO_PULLUP_ENABLE,
-        .scl_pullup_en = GPIO_PULLUP_ENABLE,
-        .master.clk_speed = config->i2c_freq
+        .clk_source = I2C_CLK_SRC_DEFAULT,
+        .glitch_ignore_cnt = 7,
+        .flags.enable_internal_pullup = true,
     };
     
-    esp_err_t ret = i2c_param_config(config->i2c_port, &i2c_conf);
+    esp_err_t ret = i2c_new_master_bus(&bus_conf, &touch_bus);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "I2C param config failed: %s", esp_err_to_name(ret));
+        ESP_LOGE(TAG, "I2C bus init failed: %s", esp_err_to_name(ret));
         return false;
     }
     
-    ret = i2c_driver_install(config->i2c_port, I2C_MODE_MASTER, 0, 0, 0);
-    if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) {
-        ESP_LOGE(TAG, "I2C driver install failed: %s", esp_err_to_name(ret));
+    uint32_t freq = config->i2c_freq ? config->i2c_freq : FT6236_I2C_FREQ_FAST;
+    if (freq > FT6236_I2C_FREQ_FAST_PLUS) {
+        freq = FT6236_I2C_FREQ_FAST_PLUS;
+    }
+    ret = add_device(freq);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "I2C device add failed: %s", esp_err_to_name(ret));
+        i2c_del_master_bus(touch_bus);
+        touch_bus = NULL;
         return false;
     }
     
@@ -121,31 +133,56 @@ bool ft6236_init(const ft6236_config_t *config) {
     
     initialized = true;
     
-    // Small delay for chip to be ready
-    vTaskDelay(pdMS_TO_TICKS(50));
-    
-    // Verify communication by reading chip ID or status
-    uint8_t test_read;
-    ret = ft6236_i2c_read(FT6236_REG_TD_STATUS, &test_read, 1);
+    // Poll until the controller ACKs instead of sleeping a fixed time
+    int64_t deadline = esp_timer_get_time() + FT6236_READY_TIMEOUT_US;
+    do {
+        ret = ft6236_i2c_read(FT6236_REG_TD_STATUS, rx_buf, 1);
+        if (ret == ESP_OK) {
+            break;
+        }
+        vTaskDelay(1);
+    } while (esp_timer_get_time() < deadline);
+    if (ret != ESP_OK && freq > FT6236_I2C_FREQ_FAST) {
+        // Fast-mode Plus needs strong pull-ups and short wiring; fall back to 400 kHz
+        ESP_LOGW(TAG, "No response at %lu Hz, falling back to %d Hz",
+                 (unsigned long)freq, FT6236_I2C_FREQ_FAST);
+        freq = FT6236_I2C_FREQ_FAST;
+        if (add_device(freq) != ESP_OK) {
+            ESP_LOGE(TAG, "I2C device add failed");
+            initialized = false;
+            i2c_del_master_bus(touch_bus);
+            touch_bus = NULL;
+            return false;
+        }
+        ret = ft6236_i2c_read(FT6236_REG_TD_STATUS, rx_buf, 1);
+    }
     if (ret != ESP_OK) {
         ESP_LOGW(TAG, "FT6236 communication test warning: %s", esp_err_to_name(ret));
         // Don't fail - some chips may not respond until first touch
     }
     
-    ESP_LOGI(TAG, "FT6236 initialized successfully");
+    touch_config.i2c_freq = freq;
+    ESP_LOGI(TAG, "FT6236 initialized successfully (%lu Hz)", (unsigned long)freq);
     return true;
 }
 
 bool ft6236_read_touch(ft6236_touch_t *touch_data) {
+    return ft6236_read_report(touch_data) && touch_data->touch_count > 0;
+}
+
+bool ft6236_read_report(ft6236_touch_t *touch_data) {
     if (!initialized || !touch_data) {
         return false;
     }
     
     memset(touch_data, 0, sizeof(ft6236_touch_t));
     
-    // Read 13 bytes starting from register 0x00
-    uint8_t buf[13];
-    esp_err_t ret = ft6236_i2c_read(FT6236_REG_MODE, buf, 13);
+    // Read the report registers starting from 0x00 in one transfer
+    uint8_t buf[FT6236_REPORT_SIZE];
+    xSemaphoreTake(xfer_lock, portMAX_DELAY);
+    esp_err_t ret = ft6236_i2c_read(FT6236_REG_MODE, rx_buf, FT6236_REPORT_SIZE);
+    memcpy(buf, rx_buf, sizeof(buf));
+    xSemaphoreGive(xfer_lock);
     if (ret != ESP_OK) {
         return false;
     }
@@ -161,7 +198,7 @@ bool ft6236_read_touch(ft6236_touch_t *touch_data) {
     touch_data->touch_count = touch_count;
     
     if (touch_count == 0) {
-        return false; // No touch detected
+        return true; // No touch detected
     }
     
     // Parse first touch point
@@ -188,26 +225,56 @@ bool ft6236_is_touched(void) {
         return false;
     }
     
-    uint8_t status;
-    esp_err_t ret = ft6236_i2c_read(FT6236_REG_TD_STATUS, &status, 1);
+    xSemaphoreTake(xfer_lock, portMAX_DELAY);
+    esp_err_t ret = ft6236_i2c_read(FT6236_REG_TD_STATUS, rx_buf, 1);
+    uint8_t touch_count = rx_buf[0] & 0x0F;
+    xSemaphoreGive(xfer_lock);
     if (ret != ESP_OK) {
         return false;
     }
-    
-    uint8_t touch_count = status & 0x0F;
+
     return (touch_count > 0);
 }
 
 bool ft6236_read_register(uint8_t reg, uint8_t *data) {
-    if (!data) {
+    if (!initialized || !data) {
         return false;
     }
     
-    esp_err_t ret = ft6236_i2c_read(reg, data, 1);
+    xSemaphoreTake(xfer_lock, portMAX_DELAY);
+    esp_err_t ret = ft6236_i2c_read(reg, rx_buf, 1);
+    *data = rx_buf[0];
+    xSemaphoreGive(xfer_lock);
     return (ret == ESP_OK);
 }
 
 bool ft6236_write_register(uint8_t reg, uint8_t data) {
+    if (!initialized) {
+        return false;
+    }
+    
+    xSemaphoreTake(xfer_lock, portMAX_DELAY);
     esp_err_t ret = ft6236_i2c_write(reg, data);
+    xSemaphoreGive(xfer_lock);
     return (ret == ESP_OK);
 }
+
+bool ft6236_set_interrupt_mode(bool trigger) {
+    return ft6236_write_register(FT6236_REG_G_MODE, trigger ? 1 : 0);
+}
+
+bool ft6236_set_power_config(const ft6236_power_config_t *power) {
+    if (!power) {
+        return false;
+    }
+    
+    bool ok = ft6236_write_register(FT6236_REG_RATE_ACTIVE, power->rate_active);
+    ok &= ft6236_write_register(FT6236_REG_RATE_MONITOR, power->rate_monitor);
+    ok &= ft6236_write_register(FT6236_REG_TIME_MONITOR, power->monitor_delay_s);
+    ok &= ft6236_write_register(FT6236_REG_G_CTRL, power->auto_monitor ? 1 : 0);
+    return ok;
+}
+
+bool ft6236_set_monitor_rate(uint8_t rate) {
+    return ft6236_write_register(FT6236_REG_RATE_MONITOR, rate);
+}
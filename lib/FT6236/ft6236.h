@@ -14,6 +14,37 @@ extern "C" {
 // Maximum touch points supported
 #define FT6236_MAX_TOUCHES 2
 
+// Registers 0x00-0x0C read per report
+#define FT6236_REPORT_SIZE 13
+
+// I2C clock rates
+#define FT6236_I2C_FREQ_FAST       400000   // Fast-mode, works with the internal pull-ups
+#define FT6236_I2C_FREQ_FAST_PLUS  1000000  // Fast-mode Plus, needs ~2.2k external pull-ups
+
+// Hardware gestures (GEST_ID register, controller orientation)
+typedef enum {
+    FT6236_GESTURE_NONE       = 0x00,
+    FT6236_GESTURE_MOVE_UP    = 0x10,
+    FT6236_GESTURE_MOVE_RIGHT = 0x14,
+    FT6236_GESTURE_MOVE_DOWN  = 0x18,
+    FT6236_GESTURE_MOVE_LEFT  = 0x1C,
+    FT6236_GESTURE_ZOOM_IN    = 0x48,
+    FT6236_GESTURE_ZOOM_OUT   = 0x49,
+} ft6236_gesture_t;
+
+// Power management. In monitor mode the controller scans slowly until a
+// finger lands, then switches to active mode on its own.
+typedef struct {
+    uint8_t rate_active;      // ID_G_PERIODACTIVE: report rate while touched
+    uint8_t rate_monitor;     // ID_G_PERIODMONITOR: scan rate in monitor mode
+    uint8_t monitor_delay_s;  // ID_G_TIMEENTERMONITOR: seconds without touch before monitor mode
+    bool auto_monitor;        // ID_G_CTRL: allow the switch to monitor mode
+} ft6236_power_config_t;
+
+#define FT6236_RATE_ACTIVE_FAST    14   // Highest active report rate (datasheet range 3-14)
+#define FT6236_RATE_MONITOR        40   // Controller default (0x28)
+#define FT6236_RATE_MONITOR_IDLE   20   // Screensaver: slower scan, wake-up still well under 100 ms
+
 // Touch point data structure
 typedef struct {
     uint16_t x;
@@ -35,9 +66,14 @@ typedef struct {
     int pin_sda;       // SDA pin
     int pin_scl;       // SCL pin
     int pin_int;       // Interrupt pin (-1 if not used)
-    uint32_t i2c_freq; // I2C frequency in Hz (e.g., 400000)
+    uint32_t i2c_freq; // I2C frequency in Hz (up to FT6236_I2C_FREQ_FAST_PLUS; falls back to 400 kHz)
 } ft6236_config_t;
 
+/*
+ * Uses the i2c_master bus/device driver with one persistent device handle and
+ * static transfer buffers behind a static mutex, so reads allocate nothing.
+ */
+
 /**
  * @brief Initialize FT6236 touch controller
  * @param config I2C and pin configuration
@@ -52,6 +88,33 @@ bool ft6236_init(const ft6236_config_t *config);
  */
 bool ft6236_read_touch(ft6236_touch_t *touch_data);
 
+/**
+ * @brief Read the touch report, including "no touch" reports
+ * @param touch_data Pointer to touch data structure to fill
+ * @return true if the controller was read (touch_count may be 0), false on I2C error
+ */
+bool ft6236_read_report(ft6236_touch_t *touch_data);
+
+/**
+ * @brief Select the CTP_INT behaviour
+ * @param trigger true: one pulse per report; false: held low while touched (default)
+ * @return true on success, false on failure
+ */
+bool ft6236_set_interrupt_mode(bool trigger);
+
+/**
+ * @brief Configure active/monitor scanning
+ * @param power Rates and monitor-mode entry delay
+ * @return true on success, false on failure
+ */
+bool ft6236_set_power_config(const ft6236_power_config_t *power);
+
+/**
+ * @brief Set only the monitor-mode scan rate
+ * @return true on success, false on failure
+ */
+bool ft6236_set_monitor_rate(uint8_t rate);
+
 /**
  * @brief Check if touch screen is currently touched
  * @return true if touched, false otherwise
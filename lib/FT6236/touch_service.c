@@ -0,0 +1,252 @@
+#include "touch_service.h"
+#include "freertos/task.h"
+#include "freertos/event_groups.h"
+#include "driver/gpio.h"
+#include "esp_timer.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include <stdatomic.h>
+#include <string.h>
+
+static const char *TAG = "TOUCH_SVC";
+
+#define RING_MASK        (TOUCH_SERVICE_RING_SIZE - 1)
+#define NEW_SAMPLE_BIT   (1 << 0)
+
+// Seqlock slot: version is odd while the task rewrites the sample
+typedef struct {
+    atomic_uint version;
+    touch_sample_t sample;
+} sample_slot_t;
+
+static sample_slot_t ring[TOUCH_SERVICE_RING_SIZE];
+static atomic_uint head = 0;                 // Sequence number of the newest sample
+static atomic_llong last_touch_us = 0;
+static touch_service_stats_t stats;
+
+static TaskHandle_t service_task = NULL;
+static EventGroupHandle_t touch_events = NULL;
+static volatile int int_pin = -1;
+static volatile int64_t irq_time_us = 0;      // Time of the latest CTP_INT edge
+static volatile uint32_t irq_count = 0;
+static atomic_int monitor_rate_request = -1;  // Applied by the task, which owns the I2C traffic
+static touch_service_cb_t sample_cb = NULL;
+static void *sample_cb_ctx = NULL;
+
+static void IRAM_ATTR touch_isr(void *arg) {
+    (void)arg;
+    irq_time_us = esp_timer_get_time();
+    irq_count++;
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(service_task, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+static void publish(const touch_sample_t *sample) {
+    uint32_t seq = atomic_load_explicit(&head, memory_order_relaxed) + 1;
+    sample_slot_t *slot = &ring[seq & RING_MASK];
+
+    atomic_fetch_add_explicit(&slot->version, 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    slot->sample = *sample;
+    slot->sample.seq = seq;
+    atomic_fetch_add_explicit(&slot->version, 1, memory_order_release);
+    atomic_store_explicit(&head, seq, memory_order_release);
+
+    stats.samples++;
+
+    // Pulse: wakes every consumer blocked in touch_service_wait()
+    xEventGroupSetBits(touch_events, NEW_SAMPLE_BIT);
+    xEventGroupClearBits(touch_events, NEW_SAMPLE_BIT);
+
+    touch_service_cb_t cb = sample_cb;
+    if (cb) {
+        cb(&slot->sample, sample_cb_ctx);
+    }
+}
+
+// Copy sample seq out of the ring; false if it has been overwritten
+static bool read_slot(uint32_t seq, touch_sample_t *out) {
+    const sample_slot_t *slot = &ring[seq & RING_MASK];
+    for (;;) {
+        unsigned v1 = atomic_load_explicit(&slot->version, memory_order_acquire);
+        if (v1 & 1) {
+            continue;  // Being written; the task finishes within a few instructions
+        }
+        *out = slot->sample;
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&slot->version, memory_order_relaxed) == v1) {
+            return out->seq == seq;
+        }
+    }
+}
+
+static void service_task_fn(void *arg) {
+    (void)arg;
+    bool pressed = false;
+
+    while (true) {
+        int64_t detect_us;
+        if (int_pin >= 0) {
+            TickType_t wait = pdMS_TO_TICKS(pressed ? TOUCH_SERVICE_LIFT_MS : TOUCH_SERVICE_IDLE_MS);
+            uint32_t irqs = irq_count;
+            ulTaskNotifyTake(pdTRUE, wait);
+            detect_us = irq_count != irqs ? irq_time_us : esp_timer_get_time();
+        } else {
+            vTaskDelay(pdMS_TO_TICKS(TOUCH_SERVICE_POLL_MS));
+            detect_us = esp_timer_get_time();
+        }
+
+        int rate = atomic_exchange(&monitor_rate_request, -1);
+        if (rate >= 0 && !ft6236_set_monitor_rate((uint8_t)rate)) {
+            ESP_LOGW(TAG, "Failed to set monitor rate %d", rate);
+        }
+
+        ft6236_touch_t touch;
+        stats.reads++;
+        if (!ft6236_read_report(&touch)) {
+            stats.errors++;
+            continue;
+        }
+
+        // Releases are published once; idle "no touch" reads are not
+        if (touch.touch_count == 0 && !pressed) {
+            continue;
+        }
+        pressed = touch.touch_count > 0;
+
+        touch_sample_t sample = {
+            .time_us = detect_us,
+            .read_us = esp_timer_get_time(),
+            .x = touch.points[0].x,
+            .y = touch.points[0].y,
+            .touch_count = touch.touch_count,
+            .gesture = touch.gesture,
+        };
+        if (pressed) {
+            atomic_store(&last_touch_us, sample.read_us);
+        }
+        publish(&sample);
+    }
+}
+
+bool touch_service_start(int pin_int, int core) {
+    if (service_task != NULL) {
+        return true;
+    }
+
+    touch_events = xEventGroupCreate();
+    if (touch_events == NULL) {
+        return false;
+    }
+
+    // Scan fast while touched, drop to monitor mode shortly after the finger lifts
+    ft6236_power_config_t power = {
+        .rate_active = FT6236_RATE_ACTIVE_FAST,
+        .rate_monitor = FT6236_RATE_MONITOR,
+        .monitor_delay_s = TOUCH_SERVICE_MONITOR_DELAY_S,
+        .auto_monitor = true,
+    };
+    if (!ft6236_set_power_config(&power)) {
+        ESP_LOGW(TAG, "Failed to configure touch power modes");
+    }
+
+    int_pin = pin_int;
+    if (xTaskCreatePinnedToCore(service_task_fn, "touch", TOUCH_SERVICE_STACK_SIZE, NULL,
+                                TOUCH_SERVICE_PRIORITY, &service_task, core) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create touch task");
+        vEventGroupDelete(touch_events);
+        touch_events = NULL;
+        return false;
+    }
+
+    // One INT pulse per report instead of a level held while touched
+    if (int_pin >= 0) {
+        esp_err_t ret = gpio_install_isr_service(0);
+        if ((ret == ESP_OK || ret == ESP_ERR_INVALID_STATE) &&
+            ft6236_set_interrupt_mode(true) &&
+            gpio_isr_handler_add(int_pin, touch_isr, NULL) == ESP_OK) {
+            ESP_LOGI(TAG, "Touch service started (CTP_INT on GPIO %d)", int_pin);
+            return true;
+        }
+        ESP_LOGW(TAG, "CTP_INT setup failed, polling every %d ms", TOUCH_SERVICE_POLL_MS);
+        int_pin = -1;
+        xTaskNotifyGive(service_task);
+        return true;
+    }
+
+    ESP_LOGI(TAG, "Touch service started (polling every %d ms)", TOUCH_SERVICE_POLL_MS);
+    return true;
+}
+
+bool touch_service_next(uint32_t *cursor, touch_sample_t *out) {
+    if (cursor == NULL || out == NULL) {
+        return false;
+    }
+
+    for (;;) {
+        uint32_t newest = atomic_load_explicit(&head, memory_order_acquire);
+        if ((int32_t)(newest - *cursor) <= 0) {
+            return false;
+        }
+
+        // Skip samples the ring no longer holds (keep clear of the slot being written)
+        uint32_t seq = *cursor + 1;
+        if (newest - seq > TOUCH_SERVICE_RING_SIZE - 2) {
+            seq = newest - (TOUCH_SERVICE_RING_SIZE - 2);
+        }
+        if (read_slot(seq, out)) {
+            *cursor = seq;
+            return true;
+        }
+    }
+}
+
+bool touch_service_latest(touch_sample_t *out) {
+    uint32_t newest = atomic_load_explicit(&head, memory_order_acquire);
+    if (newest == 0) {
+        return false;
+    }
+    uint32_t cursor = newest - 1;
+    return touch_service_next(&cursor, out);
+}
+
+uint32_t touch_service_seq(void) {
+    return atomic_load_explicit(&head, memory_order_acquire);
+}
+
+bool touch_service_wait(uint32_t seq, TickType_t timeout) {
+    if (touch_service_seq() != seq) {
+        return true;
+    }
+    if (touch_events == NULL) {
+        vTaskDelay(timeout);
+        return false;
+    }
+    xEventGroupWaitBits(touch_events, NEW_SAMPLE_BIT, pdFALSE, pdTRUE, timeout);
+    return touch_service_seq() != seq;
+}
+
+int64_t touch_service_last_touch_us(void) {
+    return atomic_load(&last_touch_us);
+}
+
+void touch_service_set_callback(touch_service_cb_t cb, void *ctx) {
+    sample_cb = NULL;
+    sample_cb_ctx = ctx;
+    sample_cb = cb;
+}
+
+void touch_service_set_idle(bool idle) {
+    atomic_store(&monitor_rate_request, idle ? FT6236_RATE_MONITOR_IDLE : FT6236_RATE_MONITOR);
+    if (service_task != NULL) {
+        xTaskNotifyGive(service_task);
+    }
+}
+
+void touch_service_get_stats(touch_service_stats_t *out) {
+    if (out) {
+        *out = stats;
+        out->interrupts = irq_count;
+    }
+}
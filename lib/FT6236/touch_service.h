@@ -0,0 +1,127 @@
+#ifndef TOUCH_SERVICE_H
+#define TOUCH_SERVICE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "ft6236.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Touch acquisition service
+ *
+ * One task owns the FT6236 and reads it once per controller report:
+ *   - With CTP_INT wired, the controller is put in trigger mode (one INT
+ *     pulse per report) and the task reads on each pulse; a touch that goes
+ *     quiet for TOUCH_SERVICE_LIFT_MS is re-read to catch a missed lift.
+ *   - Without it, the task polls every TOUCH_SERVICE_POLL_MS.
+ *
+ * Samples are timestamped and published to a ring that any number of
+ * consumers (LVGL, the screensaver, the activity tracker) read without
+ * locks and without touching I2C. Each slot carries a sequence number that
+ * is odd while the task writes it, so a reader retries instead of seeing a
+ * torn sample, and a reader that falls more than a ring behind skips ahead.
+ * Idle polls that still read "no touch" are not published.
+ *
+ * The controller scans at its fastest active rate while touched and drops to
+ * monitor mode TOUCH_SERVICE_MONITOR_DELAY_S after the last touch.
+ * touch_service_set_idle() slows the monitor scan further (screensaver).
+ * Hardware gestures (GEST_ID) are passed through in each sample.
+ */
+
+#define TOUCH_SERVICE_RING_SIZE   16      // Power of two
+#define TOUCH_SERVICE_POLL_MS     10      // Poll period without CTP_INT (~controller report rate)
+#define TOUCH_SERVICE_IDLE_MS     1000    // Safety re-read while idle with CTP_INT
+#define TOUCH_SERVICE_LIFT_MS     50      // Re-read a pressed touch after this long without a report
+#define TOUCH_SERVICE_MONITOR_DELAY_S  2  // Idle seconds before monitor mode
+#define TOUCH_SERVICE_PRIORITY    5
+#define TOUCH_SERVICE_STACK_SIZE  3072
+
+typedef struct {
+    int64_t time_us;        // Report detected: CTP_INT edge, or start of the poll read
+    int64_t read_us;        // Report read from the controller
+    uint32_t seq;           // Sample number, from 1
+    uint16_t x;             // First point, raw controller coordinates
+    uint16_t y;
+    uint8_t touch_count;    // 0 = released
+    uint8_t gesture;        // ft6236_gesture_t from GEST_ID
+} touch_sample_t;
+
+typedef struct {
+    uint32_t reads;         // I2C report reads
+    uint32_t samples;       // Samples published
+    uint32_t interrupts;    // CTP_INT pulses
+    uint32_t errors;        // Failed reads
+} touch_service_stats_t;
+
+/**
+ * @brief Called from the touch task after each published sample; keep it short
+ */
+typedef void (*touch_service_cb_t)(const touch_sample_t *sample, void *ctx);
+
+/**
+ * @brief Start the acquisition task (ft6236_init() must have succeeded)
+ * @param pin_int CTP_INT GPIO, or -1 to poll
+ * @param core Core to pin the task to
+ * @return true if the task was started
+ */
+bool touch_service_start(int pin_int, int core);
+
+/**
+ * @brief Copy the most recent sample
+ * @return false if nothing has been published yet
+ */
+bool touch_service_latest(touch_sample_t *out);
+
+/**
+ * @brief Read the next sample after *cursor and advance the cursor
+ * @param cursor Consumer-owned position (start at 0 or touch_service_seq())
+ * @return false if the consumer is up to date
+ */
+bool touch_service_next(uint32_t *cursor, touch_sample_t *out);
+
+/**
+ * @brief Sequence number of the most recent sample (0 = none)
+ */
+uint32_t touch_service_seq(void);
+
+/**
+ * @brief Wait until a sample newer than seq is published
+ * @param seq Last sequence number the caller has seen
+ * @param timeout Maximum time to wait
+ * @return true if a newer sample exists
+ */
+bool touch_service_wait(uint32_t seq, TickType_t timeout);
+
+/**
+ * @brief Time of the last sample with a finger down (µs, esp_timer clock; 0 = never)
+ */
+int64_t touch_service_last_touch_us(void);
+
+/**
+ * @brief Select the monitor-mode scan rate (applied by the touch task)
+ * @param idle true: FT6236_RATE_MONITOR_IDLE, false: FT6236_RATE_MONITOR
+ */
+void touch_service_set_idle(bool idle);
+
+/**
+ * @brief Register a callback for new samples (NULL to remove)
+ *
+ * Lets an event-driven consumer be woken by touches instead of waiting in
+ * touch_service_wait().
+ */
+void touch_service_set_callback(touch_service_cb_t cb, void *ctx);
+
+/**
+ * @brief Get acquisition statistics
+ */
+void touch_service_get_stats(touch_service_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TOUCH_SERVICE_H
@@ -3,8 +3,15 @@
 #include "driver/gpio.h"
 #include "driver/ledc.h"
 #include "esp_log.h"
+#include "esp_memory_utils.h"
+#include "esp_timer.h"
+#include "esp_rom_sys.h"
+#include "esp_async_memcpy.h"
+#include "esp_cache.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "dma_buf.h"
 #include <string.h>
 
 static const char *TAG = "ILI9341";
@@ -12,6 +19,18 @@ static const char *TAG = "ILI9341";
 static spi_device_handle_t spi_handle = NULL;
 static ili9341_config_t display_config;
 
+// Datasheet timings (the panel has no status bit for these, so they are deadlines)
+#define RESET_PULSE_US        10       // RESX low time (min 10 us)
+#define RESET_TO_SLPOUT_US    120000   // Reset release (or power-on) to Sleep Out
+#define SLPOUT_TO_CMD_US      5000     // Sleep Out to the next command
+#define SLPOUT_SETTLE_US      120000   // Sleep Out to stable supplies (before Display On)
+
+// Largest single SPI transaction (16384 pixels * 2 bytes = 32KB)
+#define MAX_CHUNK_PIXELS      16384
+
+// Staged writes: ping-pong buffers in internal DMA RAM for flash/PSRAM sources
+#define STAGE_BUFS            2
+
 // ILI9341 commands
 #define ILI9341_SWRESET   0x01
 #define ILI9341_SLPOUT    0x11
@@ -24,6 +43,22 @@ static ili9341_config_t display_config;
 #define ILI9341_PIXFMT    0x3A
 #define ILI9341_SLPIN     0x10
 
+// Sleep until an esp_timer deadline; other boot work runs meanwhile
+static void wait_until(int64_t deadline_us) {
+    int64_t remaining = deadline_us - esp_timer_get_time();
+    if (remaining <= 0) {
+        return;
+    }
+    TickType_t ticks = pdMS_TO_TICKS(remaining / 1000);
+    if (ticks > 0) {
+        vTaskDelay(ticks);
+    }
+    remaining = deadline_us - esp_timer_get_time();
+    if (remaining > 0) {
+        esp_rom_delay_us((uint32_t)remaining);
+    }
+}
+
 static inline void gpio_set(int pin, int level) {
     gpio_set_level(pin, level);
 }
@@ -120,20 +155,22 @@ bool ili9341_init(const ili9341_config_t *config) {
         return false;
     }
     
-    // Hardware reset (if RST pin is configured)
+    // Hardware reset (if RST pin is configured); without one the power-on
+    // reset started before the app did, so usually nothing is left to wait
+    int64_t reset_done_us = 0;
     if (config->pin_rst >= 0) {
         gpio_set(config->pin_rst, 0);
-        vTaskDelay(pdMS_TO_TICKS(20));
+        esp_rom_delay_us(RESET_PULSE_US);
         gpio_set(config->pin_rst, 1);
-        vTaskDelay(pdMS_TO_TICKS(120));
-    } else {
-        // If no RST pin, wait for power-on reset to complete
-        vTaskDelay(pdMS_TO_TICKS(150));
+        reset_done_us = esp_timer_get_time();
     }
+    wait_until(reset_done_us + RESET_TO_SLPOUT_US);
     
-    // Initialization sequence (based on ER-TFTM024-3 4-wire SPI example)
+    // Initialization sequence (based on ER-TFTM024-3 4-wire SPI example).
+    // Registers are written while the supplies settle after Sleep Out.
     ili9341_send_cmd(ILI9341_SLPOUT);
-    vTaskDelay(pdMS_TO_TICKS(120));
+    int64_t slpout_us = esp_timer_get_time();
+    wait_until(slpout_us + SLPOUT_TO_CMD_US);
     
     // Power control A
     ili9341_send_cmd(0xCF);
@@ -224,17 +261,12 @@ bool ili9341_init(const ili9341_config_t *config) {
                     0x3F, 0x05, 0x0E, 0x0C, 0x37, 0x3C, 0x0F};
     ili9341_send_data(e1, 15);
     
-    // Sleep Out (already sent above, but here again as per original sequence)
-    ili9341_send_cmd(ILI9341_SLPOUT);
-    vTaskDelay(pdMS_TO_TICKS(120));
-    
     // Display Invert OFF (normal colors)
     ili9341_send_cmd(0x20);  // ILI9341_INVOFF
-    vTaskDelay(pdMS_TO_TICKS(10));
     
-    // Display ON
+    // Display ON once the supplies have settled
+    wait_until(slpout_us + SLPOUT_SETTLE_US);
     ili9341_send_cmd(ILI9341_DISPON);
-    vTaskDelay(pdMS_TO_TICKS(50));
     
     // Turn on backlight (if configured)
     if (config->pin_bl >= 0) {
@@ -274,19 +306,16 @@ void ili9341_write_color(uint16_t color) {
     ili9341_send_data(data, 2);
 }
 
-// Fast batch write for display flush - writes raw buffer directly
-void ili9341_write_pixels(const uint16_t* pixels, uint32_t length) {
-    if (length == 0) return;
-    
+// Send a DMA-capable buffer as queued transactions
+static void write_pixels_direct(const uint16_t* pixels, uint32_t length) {
     gpio_set(display_config.pin_dc, 1); // Data mode
     
     // Use larger chunks with DMA for better throughput
-    const uint32_t MAX_CHUNK = 16384; // 16384 pixels * 2 bytes = 32KB per transfer
     uint32_t remaining = length;
     const uint16_t* ptr = pixels;
     
     while (remaining > 0) {
-        uint32_t chunk = (remaining > MAX_CHUNK) ? MAX_CHUNK : remaining;
+        uint32_t chunk = (remaining > MAX_CHUNK_PIXELS) ? MAX_CHUNK_PIXELS : remaining;
         
         spi_transaction_t t = {
             .flags = 0,
@@ -307,6 +336,175 @@ void ili9341_write_pixels(const uint16_t* pixels, uint32_t length) {
     }
 }
 
+// Staging state (display owner only, like the rest of the driver)
+static dma_buf_t* stage_bufs[STAGE_BUFS];
+static bool stage_unavailable = false;         // Buffers were refused; don't retry every call
+static async_memcpy_handle_t stage_mcp = NULL; // GDMA copy engine (NULL = CPU copies only)
+static SemaphoreHandle_t stage_copy_done = NULL;
+static ili9341_stage_stats_t stage_stats;
+
+static bool IRAM_ATTR stage_copy_isr(async_memcpy_handle_t mcp, async_memcpy_event_t* event, void* arg) {
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(stage_copy_done, &woken);
+    return woken == pdTRUE;
+}
+
+static bool stage_init(void) {
+    if (stage_bufs[STAGE_BUFS - 1] != NULL) {
+        return true;
+    }
+    if (stage_unavailable) {
+        return false;
+    }
+    
+    for (int i = 0; i < STAGE_BUFS; i++) {
+        stage_bufs[i] = dma_buf_alloc(ILI9341_STAGE_PIXELS * sizeof(uint16_t), "ili_stage");
+        if (stage_bufs[i] == NULL) {
+            ESP_LOGW(TAG, "No DMA RAM for staging buffers; SPI driver will bounce");
+            for (int j = 0; j < i; j++) {
+                dma_buf_unref(stage_bufs[j]);
+                stage_bufs[j] = NULL;
+            }
+            stage_unavailable = true;
+            return false;
+        }
+    }
+    
+    // Async copies need a GDMA channel; CPU copies still overlap the SPI DMA
+    stage_copy_done = xSemaphoreCreateBinary();
+    async_memcpy_config_t mcp_config = ASYNC_MEMCPY_DEFAULT_CONFIG();
+    mcp_config.backlog = STAGE_BUFS;
+    mcp_config.psram_trans_align = ILI9341_STAGE_ASYNC_ALIGN;
+    if (stage_copy_done == NULL || esp_async_memcpy_install(&mcp_config, &stage_mcp) != ESP_OK) {
+        ESP_LOGW(TAG, "Async memcpy unavailable; staging with CPU copies");
+        stage_mcp = NULL;
+    }
+    
+    ESP_LOGI(TAG, "Staging buffers: %d x %u bytes", STAGE_BUFS,
+             (unsigned)(ILI9341_STAGE_PIXELS * sizeof(uint16_t)));
+    return true;
+}
+
+// Start copying one chunk into a stage buffer; returns true if the copy runs
+// asynchronously and stage_copy_wait() must be called before sending it
+static bool stage_copy_start(uint16_t* dst, const uint16_t* src, uint32_t pixels) {
+    size_t bytes = pixels * sizeof(uint16_t);
+    
+    // GDMA reads internal RAM and PSRAM, not flash; PSRAM needs aligned bursts
+    // and the CPU's cached writes flushed first
+    bool dma_source = esp_ptr_dma_capable(src) ||
+                      (esp_ptr_external_ram(src) &&
+                       (((uintptr_t)src | bytes) & (ILI9341_STAGE_ASYNC_ALIGN - 1)) == 0);
+    if (stage_mcp && dma_source) {
+        if (esp_ptr_external_ram(src)) {
+            esp_cache_msync((void*)src, bytes, ESP_CACHE_MSYNC_FLAG_DIR_C2M | ESP_CACHE_MSYNC_FLAG_UNALIGNED);
+        }
+        if (esp_async_memcpy(stage_mcp, dst, (void*)src, bytes, stage_copy_isr, NULL) == ESP_OK) {
+            stage_stats.async_chunks++;
+            return true;
+        }
+    }
+    
+    memcpy(dst, src, bytes);
+    stage_stats.cpu_chunks++;
+    return false;
+}
+
+static void stage_copy_wait(bool async) {
+    if (!async) {
+        return;
+    }
+    int64_t start = esp_timer_get_time();
+    xSemaphoreTake(stage_copy_done, portMAX_DELAY);
+    stage_stats.copy_wait_us += esp_timer_get_time() - start;
+}
+
+// Wait for the oldest queued staging transaction
+static void stage_collect(void) {
+    int64_t start = esp_timer_get_time();
+    spi_transaction_t* rtrans;
+    spi_device_get_trans_result(spi_handle, &rtrans, portMAX_DELAY);
+    stage_stats.spi_wait_us += esp_timer_get_time() - start;
+}
+
+void ili9341_write_pixels_staged(const uint16_t* pixels, uint32_t length) {
+    if (length == 0) return;
+    
+    if (!stage_init()) {
+        write_pixels_direct(pixels, length);
+        return;
+    }
+    
+    int64_t start = esp_timer_get_time();
+    gpio_set(display_config.pin_dc, 1); // Data mode
+    
+    // Copy chunk n + 1 while chunk n is on the bus, and queue it before chunk n
+    // finishes so the bus never idles. A stage buffer is only refilled after
+    // the transaction that read it has been collected.
+    static spi_transaction_t trans[STAGE_BUFS];
+    uint32_t chunks = (length + ILI9341_STAGE_PIXELS - 1) / ILI9341_STAGE_PIXELS;
+    uint32_t offset = 0;
+    
+    uint32_t n = length < ILI9341_STAGE_PIXELS ? length : ILI9341_STAGE_PIXELS;
+    stage_copy_wait(stage_copy_start((uint16_t*)dma_buf_data(stage_bufs[0]), pixels, n));
+    
+    for (uint32_t i = 0; i < chunks; i++) {
+        spi_transaction_t* t = &trans[i % STAGE_BUFS];
+        memset(t, 0, sizeof(*t));
+        t->length = n * 16;  // bits
+        t->tx_buffer = dma_buf_data(stage_bufs[i % STAGE_BUFS]);
+        spi_device_queue_trans(spi_handle, t, portMAX_DELAY);
+        offset += n;
+        
+        // Collect chunk n - 1, which frees the other buffer
+        if (i > 0) {
+            stage_collect();
+        }
+        
+        if (i + 1 < chunks) {
+            n = (length - offset < ILI9341_STAGE_PIXELS) ? length - offset : ILI9341_STAGE_PIXELS;
+            stage_copy_wait(stage_copy_start((uint16_t*)dma_buf_data(stage_bufs[(i + 1) % STAGE_BUFS]),
+                                             pixels + offset, n));
+        }
+    }
+    stage_collect();
+    
+    stage_stats.transfers++;
+    stage_stats.chunks += chunks;
+    stage_stats.bytes += (uint64_t)length * sizeof(uint16_t);
+    stage_stats.busy_us += esp_timer_get_time() - start;
+}
+
+// Fast batch write for display flush - DMA-capable buffers go straight to the
+// SPI DMA; flash and PSRAM sources are staged through internal DMA RAM
+void ili9341_write_pixels(const uint16_t* pixels, uint32_t length) {
+    if (length == 0) return;
+    
+    if (!esp_ptr_dma_capable(pixels) || ((uintptr_t)pixels & 3) != 0) {
+        ili9341_write_pixels_staged(pixels, length);
+        return;
+    }
+    
+    write_pixels_direct(pixels, length);
+}
+
+void ili9341_get_stage_stats(ili9341_stage_stats_t* stats) {
+    *stats = stage_stats;
+}
+
+void ili9341_log_stage_stats(void) {
+    if (stage_stats.transfers == 0) {
+        return;
+    }
+    uint32_t kbps = stage_stats.busy_us ? (uint32_t)(stage_stats.bytes * 1000 / stage_stats.busy_us) : 0;
+    ESP_LOGI(TAG, "Staged: %lu writes, %lu chunks (%lu async, %lu cpu), %llu bytes, %lu KB/s, "
+             "spi wait %llu us, copy wait %llu us",
+             (unsigned long)stage_stats.transfers, (unsigned long)stage_stats.chunks,
+             (unsigned long)stage_stats.async_chunks, (unsigned long)stage_stats.cpu_chunks,
+             (unsigned long long)stage_stats.bytes, (unsigned long)kbps,
+             (unsigned long long)stage_stats.spi_wait_us, (unsigned long long)stage_stats.copy_wait_us);
+}
+
 void ili9341_write_colors(const uint16_t* colors, uint32_t length) {
     if (length == 0) return;
     
@@ -107,6 +107,21 @@ extern "C" {
 #define ILI9341_NAVY     0x000F
 #define ILI9341_LIGHTGRAY 0xF7DE
 
+// Staged writes (ili9341_write_pixels_staged)
+#define ILI9341_STAGE_PIXELS       4096  // Pixels per stage buffer (2 x 8 KB internal DMA RAM)
+#define ILI9341_STAGE_ASYNC_ALIGN  64    // PSRAM address/length alignment for async memcpy
+
+typedef struct {
+    uint32_t transfers;      // Staged writes
+    uint32_t chunks;         // Stage buffers sent
+    uint32_t async_chunks;   // Chunks copied by the async memcpy GDMA channel
+    uint32_t cpu_chunks;     // Chunks copied by the CPU (flash or unaligned sources)
+    uint64_t bytes;          // Pixel bytes sent
+    uint64_t busy_us;        // Time inside staged writes (bytes / busy_us = throughput)
+    uint64_t spi_wait_us;    // Time spent waiting for SPI transactions
+    uint64_t copy_wait_us;   // Time spent waiting for async copies
+} ili9341_stage_stats_t;
+
 // Pin configuration structure
 typedef struct {
     int pin_mosi;
@@ -191,6 +206,36 @@ void ili9341_write_color(uint16_t color);
  */
 void ili9341_write_colors(const uint16_t* colors, uint32_t length);
 
+/**
+ * @brief Write pixels to the address window (bulk DMA transfer)
+ *
+ * DMA-capable buffers are sent as is. Anything else (flash rodata, PSRAM,
+ * unaligned pointers) goes through ili9341_write_pixels_staged().
+ */
+void ili9341_write_pixels(const uint16_t* pixels, uint32_t length);
+
+/**
+ * @brief Write pixels from memory the SPI DMA cannot read directly
+ *
+ * Chunks are copied into two internal DMA buffers of ILI9341_STAGE_PIXELS
+ * each; the next chunk is copied while the previous one is on the bus. PSRAM
+ * sources are copied by the async memcpy GDMA channel when aligned to
+ * ILI9341_STAGE_ASYNC_ALIGN, flash and unaligned sources by the CPU. Falls
+ * back to a direct write (SPI driver bounce buffers) if the stage buffers
+ * cannot be allocated.
+ */
+void ili9341_write_pixels_staged(const uint16_t* pixels, uint32_t length);
+
+/**
+ * @brief Read the staged write counters
+ */
+void ili9341_get_stage_stats(ili9341_stage_stats_t* stats);
+
+/**
+ * @brief Log the staged write counters and throughput (nothing if unused)
+ */
+void ili9341_log_stage_stats(void);
+
 /**
  * @brief Set backlight brightness (0-255)
  * @param brightness Brightness percentage
@@ -6,8 +6,10 @@
 #include "lvgl_port.h"
 #include "lvgl.h"
 #include "../ILI9341/ili9341.h"
-#include "../FT6236/ft6236.h"
+#include "../FT6236/touch_service.h"
+#include "touch_latency.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 
@@ -21,9 +23,22 @@ static lv_color_t disp_buf1[DISP_BUF_SIZE];
 static lv_display_t *disp;
 static lv_indev_t *indev_touchpad;
 
+/* Hardware gesture events */
+static uint32_t gesture_event_code;
+static uint32_t gesture_cursor;
+
 /* Forward declarations */
 static void disp_flush(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map);
 static void touchpad_read(lv_indev_t *indev, lv_indev_data_t *data);
+static void latency_event_cb(lv_event_t *e);
+
+/* LVGL tick in ms from esp_timer: the FreeRTOS tick (10 ms at HZ=100) is too
+ * coarse for LVGL's 1-5 ms deadlines; a run between OS ticks would see no
+ * time pass and do nothing */
+static uint32_t tick_get_ms(void)
+{
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
 
 bool lvgl_port_init(void)
 {
@@ -31,6 +46,7 @@ bool lvgl_port_init(void)
     
     /* Initialize LVGL */
     lv_init();
+    lv_tick_set_cb(tick_get_ms);
     
     /* Create display */
     disp = lv_display_create(ILI9341_WIDTH, ILI9341_HEIGHT);
@@ -55,22 +71,55 @@ bool lvgl_port_init(void)
     lv_indev_set_type(indev_touchpad, LV_INDEV_TYPE_POINTER);
     lv_indev_set_read_cb(indev_touchpad, touchpad_read);
     
+    /* Touch-to-photon trace points */
+    lv_indev_add_event_cb(indev_touchpad, latency_event_cb, LV_EVENT_PRESSED, NULL);
+    lv_display_add_event_cb(disp, latency_event_cb, LV_EVENT_RENDER_START, NULL);
+    
+    gesture_event_code = lv_event_register_id();
+    gesture_cursor = touch_service_seq();
+    
     ESP_LOGI(TAG, "LVGL initialized successfully");
     return true;
 }
 
-void lvgl_port_task_handler(void)
+/* Controller gesture to screen orientation (panel is rotated: screen x follows -raw y, screen y follows raw x) */
+static bool map_gesture(uint8_t gesture, lvgl_port_gesture_t *out)
 {
-    // Update LVGL tick (in milliseconds)
-    static uint32_t last_tick = 0;
-    uint32_t now = xTaskGetTickCount() * portTICK_PERIOD_MS;
-    uint32_t elapsed = now - last_tick;
-    if (elapsed > 0) {
-        lv_tick_inc(elapsed);
-        last_tick = now;
+    switch (gesture) {
+        case FT6236_GESTURE_MOVE_UP:    *out = LVGL_PORT_GESTURE_SWIPE_RIGHT; return true;
+        case FT6236_GESTURE_MOVE_DOWN:  *out = LVGL_PORT_GESTURE_SWIPE_LEFT;  return true;
+        case FT6236_GESTURE_MOVE_LEFT:  *out = LVGL_PORT_GESTURE_SWIPE_UP;    return true;
+        case FT6236_GESTURE_MOVE_RIGHT: *out = LVGL_PORT_GESTURE_SWIPE_DOWN;  return true;
+        case FT6236_GESTURE_ZOOM_IN:    *out = LVGL_PORT_GESTURE_ZOOM_IN;     return true;
+        case FT6236_GESTURE_ZOOM_OUT:   *out = LVGL_PORT_GESTURE_ZOOM_OUT;    return true;
+        default:                        return false;
     }
+}
+
+/* Send one event per new hardware gesture to the active screen */
+static void dispatch_gestures(void)
+{
+    static uint8_t last_gesture = FT6236_GESTURE_NONE;
+    touch_sample_t sample;
     
-    lv_timer_handler();
+    while (touch_service_next(&gesture_cursor, &sample)) {
+        lvgl_port_gesture_t gesture;
+        if (sample.gesture != last_gesture && map_gesture(sample.gesture, &gesture)) {
+            lv_obj_send_event(lv_screen_active(), (lv_event_code_t)gesture_event_code, &gesture);
+        }
+        last_gesture = sample.touch_count > 0 ? sample.gesture : FT6236_GESTURE_NONE;
+    }
+}
+
+uint32_t lvgl_port_gesture_event(void)
+{
+    return gesture_event_code;
+}
+
+uint32_t lvgl_port_task_handler(void)
+{
+    dispatch_gestures();
+    return lv_timer_handler();
 }
 
 /* Display flush callback */
@@ -93,6 +142,11 @@ static void disp_flush(lv_display_t *disp_drv, const lv_area_t *area, uint8_t *p
     extern void ili9341_write_pixels(const uint16_t* pixels, uint32_t length);
     ili9341_write_pixels(color_p, size);
     
+    /* Returns after the DMA finished, so this is when the pixels reach the panel */
+    if (touch_latency_pending(TOUCH_STAGE_FLUSH)) {
+        touch_latency_mark(TOUCH_STAGE_FLUSH);
+    }
+    
     /* Indicate flush is complete */
     lv_display_flush_ready(disp_drv);
 }
@@ -102,11 +156,18 @@ static void touchpad_read(lv_indev_t *indev_drv, lv_indev_data_t *data)
 {
     static int16_t last_x = 0;
     static int16_t last_y = 0;
+    static bool was_pressed = false;
     
-    ft6236_touch_t touch_data;
-    if (ft6236_read_touch(&touch_data) && touch_data.touch_count > 0) {
-        uint16_t raw_x = touch_data.points[0].x;
-        uint16_t raw_y = touch_data.points[0].y;
+    /* Latest sample from the touch service - no I2C traffic here */
+    touch_sample_t sample;
+    if (touch_service_latest(&sample) && sample.touch_count > 0) {
+        if (!was_pressed) {
+            touch_latency_begin(sample.time_us, sample.read_us);  /* Finger just landed */
+        }
+        was_pressed = true;
+        
+        uint16_t raw_x = sample.x;
+        uint16_t raw_y = sample.y;
         
         // Calibrated coordinate mapping (same as original code)
         int32_t x = 320 - ((raw_y - 31) * 320) / 285;  
@@ -132,5 +193,16 @@ static void touchpad_read(lv_indev_t *indev_drv, lv_indev_data_t *data)
         data->point.x = last_x;
         data->point.y = last_y;
         data->state = LV_INDEV_STATE_RELEASED;
+        was_pressed = false;
+    }
+}
+
+/* Latency trace: press event reached LVGL, then the first render after it */
+static void latency_event_cb(lv_event_t *e)
+{
+    if (lv_event_get_code(e) == LV_EVENT_PRESSED) {
+        touch_latency_mark(TOUCH_STAGE_EVENT);
+    } else {
+        touch_latency_mark(TOUCH_STAGE_RENDER);
     }
 }
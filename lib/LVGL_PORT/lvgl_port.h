@@ -11,6 +11,21 @@ extern "C" {
 #endif
 
 #include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Hardware gestures from the touch controller, in screen orientation.
+ * Sent to the active screen as the lvgl_port_gesture_event() event code with
+ * a pointer to one of these as the event parameter.
+ */
+typedef enum {
+    LVGL_PORT_GESTURE_SWIPE_LEFT = 0,
+    LVGL_PORT_GESTURE_SWIPE_RIGHT,
+    LVGL_PORT_GESTURE_SWIPE_UP,
+    LVGL_PORT_GESTURE_SWIPE_DOWN,
+    LVGL_PORT_GESTURE_ZOOM_IN,
+    LVGL_PORT_GESTURE_ZOOM_OUT,
+} lvgl_port_gesture_t;
 
 /**
  * Initialize LVGL with display and touch drivers
@@ -20,8 +35,14 @@ bool lvgl_port_init(void);
 
 /**
  * Task handler for LVGL - call periodically
+ * @return Milliseconds until LVGL next needs to run (LV_NO_TIMER_READY if never)
+ */
+uint32_t lvgl_port_task_handler(void);
+
+/**
+ * Event code used for hardware gestures (valid after lvgl_port_init())
  */
-void lvgl_port_task_handler(void);
+uint32_t lvgl_port_gesture_event(void);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,155 @@
+#include "touch_latency.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "LATENCY";
+
+// Log-linear buckets: values below 8 us are exact, then 8 per octave up to ~2^21 us
+#define SUB_BITS     3
+#define SUB_COUNT    (1 << SUB_BITS)
+#define OCTAVES      19
+#define BUCKETS      (SUB_COUNT + OCTAVES * SUB_COUNT)
+
+typedef struct {
+    uint16_t counts[BUCKETS];
+    uint32_t total;
+    uint32_t max_us;
+} histogram_t;
+
+// Histogram 0 is the total, 1..N the delta into each stage after DETECT
+static histogram_t hist[TOUCH_STAGE_COUNT];
+static int64_t stamps[TOUCH_STAGE_COUNT];
+static int next_stage = TOUCH_STAGE_COUNT;  // TOUCH_STAGE_COUNT = no trace
+static uint32_t abandoned;
+
+static const char *stage_names[TOUCH_STAGE_COUNT] = {
+    "total", "detect>read", "read>indev", "indev>event", "event>render", "render>flush",
+};
+
+static int bucket_of(uint32_t us) {
+    if (us < SUB_COUNT) {
+        return us;
+    }
+    int msb = 31 - __builtin_clz(us);
+    int b = SUB_COUNT + (msb - SUB_BITS) * SUB_COUNT + ((us >> (msb - SUB_BITS)) & (SUB_COUNT - 1));
+    return b < BUCKETS ? b : BUCKETS - 1;
+}
+
+// Upper bound of a bucket, used as the reported value
+static uint32_t bucket_high(int b) {
+    if (b < SUB_COUNT) {
+        return b;
+    }
+    int octave = (b - SUB_COUNT) / SUB_COUNT;
+    int sub = (b - SUB_COUNT) % SUB_COUNT;
+    uint32_t base = (uint32_t)(SUB_COUNT + sub) << octave;
+    return base + (1u << octave) - 1;
+}
+
+static void record(histogram_t *h, int64_t us) {
+    uint32_t v = us < 0 ? 0 : (us > UINT32_MAX ? UINT32_MAX : (uint32_t)us);
+    uint16_t *c = &h->counts[bucket_of(v)];
+    if (*c < UINT16_MAX) {
+        (*c)++;
+    }
+    h->total++;
+    if (v > h->max_us) {
+        h->max_us = v;
+    }
+}
+
+static uint32_t percentile(const histogram_t *h, uint32_t pct) {
+    uint32_t target = (h->total * pct + 99) / 100;
+    uint32_t seen = 0;
+    for (int b = 0; b < BUCKETS; b++) {
+        seen += h->counts[b];
+        if (seen >= target && seen > 0) {
+            uint32_t high = bucket_high(b);
+            return high < h->max_us ? high : h->max_us;
+        }
+    }
+    return h->max_us;
+}
+
+void touch_latency_begin(int64_t detect_us, int64_t read_us) {
+    if (next_stage != TOUCH_STAGE_COUNT) {
+        abandoned++;  // Previous press never reached the panel
+    }
+    stamps[TOUCH_STAGE_DETECT] = detect_us;
+    stamps[TOUCH_STAGE_READ] = read_us;
+    stamps[TOUCH_STAGE_INDEV] = esp_timer_get_time();
+    next_stage = TOUCH_STAGE_EVENT;
+}
+
+bool touch_latency_pending(touch_stage_t stage) {
+    return next_stage == (int)stage;
+}
+
+void touch_latency_mark(touch_stage_t stage) {
+    if (next_stage != (int)stage) {
+        return;
+    }
+
+    int64_t now = esp_timer_get_time();
+    if (now - stamps[TOUCH_STAGE_DETECT] > TOUCH_LATENCY_TIMEOUT_US) {
+        abandoned++;
+        next_stage = TOUCH_STAGE_COUNT;
+        return;
+    }
+    stamps[stage] = now;
+    if (stage + 1 < TOUCH_STAGE_COUNT) {
+        next_stage = stage + 1;
+        return;
+    }
+
+    // Complete: record every stage delta and the total
+    for (int s = TOUCH_STAGE_READ; s < TOUCH_STAGE_COUNT; s++) {
+        record(&hist[s], stamps[s] - stamps[s - 1]);
+    }
+    record(&hist[0], stamps[TOUCH_STAGE_FLUSH] - stamps[TOUCH_STAGE_DETECT]);
+    next_stage = TOUCH_STAGE_COUNT;
+}
+
+void touch_latency_report(void) {
+    if (hist[0].total == 0) {
+        ESP_LOGI(TAG, "No complete touch traces (%lu abandoned)", (unsigned long)abandoned);
+        return;
+    }
+
+    ESP_LOGI(TAG, "%lu touches traced, %lu abandoned (no redraw within %d ms)",
+             (unsigned long)hist[0].total, (unsigned long)abandoned, TOUCH_LATENCY_TIMEOUT_US / 1000);
+    printf("LATENCY,stage,count,p50_us,p90_us,p99_us,max_us\n");
+    for (int s = 0; s < TOUCH_STAGE_COUNT; s++) {
+        const histogram_t *h = &hist[s];
+        printf("LATENCY,%s,%lu,%lu,%lu,%lu,%lu\n", stage_names[s], (unsigned long)h->total,
+               (unsigned long)percentile(h, 50), (unsigned long)percentile(h, 90),
+               (unsigned long)percentile(h, 99), (unsigned long)h->max_us);
+    }
+
+    // Total latency histogram, one row per occupied bucket
+    const histogram_t *h = &hist[0];
+    uint16_t peak = 1;
+    for (int b = 0; b < BUCKETS; b++) {
+        if (h->counts[b] > peak) {
+            peak = h->counts[b];
+        }
+    }
+    for (int b = 0; b < BUCKETS; b++) {
+        if (h->counts[b] == 0) {
+            continue;
+        }
+        char bar[41];
+        int len = (h->counts[b] * 40 + peak - 1) / peak;
+        memset(bar, '#', len);
+        bar[len] = '\0';
+        printf("LATENCY_HIST,<=%lu us,%u,%s\n", (unsigned long)bucket_high(b), h->counts[b], bar);
+    }
+}
+
+void touch_latency_reset(void) {
+    memset(hist, 0, sizeof(hist));
+    abandoned = 0;
+    next_stage = TOUCH_STAGE_COUNT;
+}
@@ -0,0 +1,68 @@
+#ifndef TOUCH_LATENCY_H
+#define TOUCH_LATENCY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Touch-to-photon latency trace
+ *
+ * Each finger landing is followed through the stages below, stamped with the
+ * esp_timer clock. The trace completes when the first flush after LVGL
+ * starts rendering has been sent (ili9341_write_pixels() waits for the DMA,
+ * so its return is DMA completion). Touches that cause no redraw within
+ * TOUCH_LATENCY_TIMEOUT_US are counted as abandoned.
+ *
+ * Per-stage deltas and the total go into log-linear histograms (8 buckets
+ * per power of two, <= 12.5% error) and are reported as percentiles, one
+ * "LATENCY,..." CSV line per stage so releases can be compared from logs.
+ */
+
+#define TOUCH_LATENCY_TIMEOUT_US  500000
+
+typedef enum {
+    TOUCH_STAGE_DETECT = 0,   // CTP_INT edge, or start of the poll read
+    TOUCH_STAGE_READ,         // I2C report read done
+    TOUCH_STAGE_INDEV,        // LVGL indev read callback saw the press
+    TOUCH_STAGE_EVENT,        // LVGL LV_EVENT_PRESSED
+    TOUCH_STAGE_RENDER,       // First render started after the event
+    TOUCH_STAGE_FLUSH,        // Flush containing that render sent (DMA done)
+    TOUCH_STAGE_COUNT
+} touch_stage_t;
+
+/**
+ * @brief Start a trace for a new press
+ * @param detect_us Detection time from the touch sample
+ * @param read_us I2C read completion from the touch sample
+ */
+void touch_latency_begin(int64_t detect_us, int64_t read_us);
+
+/**
+ * @brief Stamp a stage of the current trace (ignored without one, or out of order)
+ */
+void touch_latency_mark(touch_stage_t stage);
+
+/**
+ * @brief Whether a trace is waiting for the given stage
+ */
+bool touch_latency_pending(touch_stage_t stage);
+
+/**
+ * @brief Print percentiles for every stage and a histogram of the total
+ */
+void touch_latency_report(void);
+
+/**
+ * @brief Clear all histograms
+ */
+void touch_latency_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TOUCH_LATENCY_H
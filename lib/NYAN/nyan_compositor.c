@@ -0,0 +1,178 @@
+#include "nyan_compositor.h"
+#include <string.h>
+
+// Cat sprites embedded in flash (generated by embed_nyan_sprites.py)
+extern const uint16_t nyan_sprite_width;
+extern const uint16_t nyan_sprite_height;
+extern const uint8_t nyan_sprite_frame_count;
+extern const uint16_t nyan_sprite_duration_ms;
+extern const uint16_t nyan_sprite_palette[16];
+extern const uint32_t nyan_sprite_frame_bytes;
+extern const uint8_t nyan_sprite_data[];
+
+// Scene layout
+#define CAT_X              150
+#define CAT_Y              ((NYAN_SCENE_HEIGHT - 84) / 2)
+#define RAINBOW_END_X      (CAT_X + 30)   // Tucked under the pop-tart
+#define RAINBOW_Y          (CAT_Y + 14)
+#define RAINBOW_STRIPE_H   9
+#define RAINBOW_STRIPES    6
+#define RAINBOW_SEGMENT_W  16             // Width of one stepped segment
+#define RAINBOW_BOB        3              // Vertical step between segments
+
+// Stars
+#define STAR_COUNT         10
+#define STAR_SPEED         12             // Pixels per frame, right to left
+#define STAR_SPAN          (NYAN_SCENE_WIDTH + 32)
+#define STAR_STAGES        6              // Twinkle cycle length in frames
+#define STAR_RADIUS        7
+
+typedef struct {
+    uint16_t x;
+    uint8_t y;
+    uint8_t phase;
+} star_t;
+
+static const star_t stars[STAR_COUNT] = {
+    { 20,  18, 0}, {110,  40, 3}, {205,  12, 1}, {290,  56, 4}, { 60, 170, 2},
+    {160, 190, 5}, {250, 160, 0}, {330, 214, 3}, { 95, 226, 1}, {240, 120, 2},
+};
+
+// Panel-ready colors, filled in by nyan_compositor_init()
+static uint16_t sky_color;
+static uint16_t star_color;
+static uint16_t rainbow_colors[RAINBOW_STRIPES];
+
+// RGB888 to panel RGB565 (same Swap+Invert as lvgl_port.c and the asset tools)
+static uint16_t panel_color(uint8_t r, uint8_t g, uint8_t b) {
+    uint16_t rgb565 = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3);
+    uint16_t swapped = (rgb565 >> 8) | (rgb565 << 8);
+    return ~swapped;
+}
+
+void nyan_compositor_init(void) {
+    sky_color = panel_color(15, 77, 143);
+    star_color = panel_color(255, 255, 255);
+    rainbow_colors[0] = panel_color(255, 0, 0);     // Red
+    rainbow_colors[1] = panel_color(255, 153, 0);   // Orange
+    rainbow_colors[2] = panel_color(255, 255, 0);   // Yellow
+    rainbow_colors[3] = panel_color(51, 255, 0);    // Green
+    rainbow_colors[4] = panel_color(0, 153, 255);   // Blue
+    rainbow_colors[5] = panel_color(102, 51, 255);  // Violet
+}
+
+uint32_t nyan_compositor_frame_ms(void) {
+    return nyan_sprite_duration_ms;
+}
+
+static void fill_span(uint16_t *row, int x0, int x1, uint16_t color) {
+    if (x0 < 0) x0 = 0;
+    if (x1 > NYAN_SCENE_WIDTH) x1 = NYAN_SCENE_WIDTH;
+    for (int x = x0; x < x1; x++) {
+        row[x] = color;
+    }
+}
+
+// Star shape by twinkle stage, dx/dy relative to the star center
+static bool star_covers(int dx, int dy, int stage) {
+    int adx = dx < 0 ? -dx : dx;
+    int ady = dy < 0 ? -dy : dy;
+    switch (stage) {
+        case 0:  // Dot
+            return adx <= 1 && ady <= 1;
+        case 1:  // Small plus
+        case 5:
+            return (adx <= 1 && ady <= 3) || (ady <= 1 && adx <= 3);
+        case 2:  // Large plus with hollow center
+        case 4:
+            return ((adx <= 1 && ady <= 5) || (ady <= 1 && adx <= 5)) && (adx > 1 || ady > 1);
+        default: // Sparkle: four separated dots
+            return (adx <= 1 && ady >= 5 && ady <= 7) || (ady <= 1 && adx >= 5 && adx <= 7);
+    }
+}
+
+static void draw_stars(uint16_t *dst, int y0, int lines, uint32_t frame) {
+    for (int i = 0; i < STAR_COUNT; i++) {
+        int cy = stars[i].y;
+        if (cy + STAR_RADIUS < y0 || cy - STAR_RADIUS >= y0 + lines) {
+            continue;
+        }
+        int cx = (int)((stars[i].x + STAR_SPAN - (frame * STAR_SPEED) % STAR_SPAN) % STAR_SPAN) - 16;
+        int stage = (stars[i].phase + frame) % STAR_STAGES;
+
+        for (int y = cy - STAR_RADIUS; y <= cy + STAR_RADIUS; y++) {
+            if (y < y0 || y >= y0 + lines) continue;
+            uint16_t *row = dst + (y - y0) * NYAN_SCENE_WIDTH;
+            for (int x = cx - STAR_RADIUS; x <= cx + STAR_RADIUS; x++) {
+                if (x < 0 || x >= NYAN_SCENE_WIDTH) continue;
+                if (star_covers(x - cx, y - cy, stage)) {
+                    row[x] = star_color;
+                }
+            }
+        }
+    }
+}
+
+static void draw_rainbow(uint16_t *dst, int y0, int lines, uint32_t frame) {
+    int top = RAINBOW_Y - RAINBOW_BOB;
+    int bottom = RAINBOW_Y + RAINBOW_BOB + RAINBOW_STRIPES * RAINBOW_STRIPE_H;
+    if (bottom <= y0 || top >= y0 + lines) {
+        return;
+    }
+
+    // Segments step up and down alternately, counted back from the cat
+    for (int seg = 0; seg * RAINBOW_SEGMENT_W < RAINBOW_END_X; seg++) {
+        int x1 = RAINBOW_END_X - seg * RAINBOW_SEGMENT_W;
+        int x0 = x1 - RAINBOW_SEGMENT_W;
+        int seg_top = RAINBOW_Y + (((seg + frame) & 1) ? RAINBOW_BOB : -RAINBOW_BOB);
+
+        for (int y = y0; y < y0 + lines; y++) {
+            int offset = y - seg_top;
+            if (offset < 0 || offset >= RAINBOW_STRIPES * RAINBOW_STRIPE_H) continue;
+            uint16_t *row = dst + (y - y0) * NYAN_SCENE_WIDTH;
+            fill_span(row, x0, x1, rainbow_colors[offset / RAINBOW_STRIPE_H]);
+        }
+    }
+}
+
+static void draw_cat(uint16_t *dst, int y0, int lines, uint32_t frame) {
+    int w = nyan_sprite_width;
+    int h = nyan_sprite_height;
+    if (CAT_Y + h <= y0 || CAT_Y >= y0 + lines) {
+        return;
+    }
+
+    const uint8_t *sprite = nyan_sprite_data + (frame % nyan_sprite_frame_count) * nyan_sprite_frame_bytes;
+    int row_bytes = w / 2;
+
+    for (int y = y0; y < y0 + lines; y++) {
+        int sy = y - CAT_Y;
+        if (sy < 0 || sy >= h) continue;
+        const uint8_t *src = sprite + sy * row_bytes;
+        uint16_t *out = dst + (y - y0) * NYAN_SCENE_WIDTH + CAT_X;
+
+        // Index 0 is transparent; sprite is fully on screen at CAT_X
+        for (int i = 0; i < row_bytes; i++) {
+            uint8_t b = src[i];
+            if (b == 0) continue;
+            uint8_t left = b >> 4;
+            uint8_t right = b & 0x0F;
+            if (left) out[i * 2] = nyan_sprite_palette[left];
+            if (right) out[i * 2 + 1] = nyan_sprite_palette[right];
+        }
+    }
+}
+
+void nyan_compose_band(uint16_t *dst, uint16_t y0, uint16_t lines, uint32_t frame) {
+    // Sky - fill two pixels per store
+    uint32_t sky2 = sky_color | ((uint32_t)sky_color << 16);
+    uint32_t *out = (uint32_t *)dst;
+    uint32_t pairs = (uint32_t)NYAN_SCENE_WIDTH * lines / 2;
+    for (uint32_t i = 0; i < pairs; i++) {
+        out[i] = sky2;
+    }
+
+    draw_stars(dst, y0, lines, frame);
+    draw_rainbow(dst, y0, lines, frame);
+    draw_cat(dst, y0, lines, frame);
+}
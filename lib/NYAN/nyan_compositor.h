@@ -0,0 +1,50 @@
+#ifndef NYAN_COMPOSITOR_H
+#define NYAN_COMPOSITOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Procedural Nyan Cat screensaver compositor
+ *
+ * Renders the scene one horizontal band at a time, right before the band is
+ * sent to the panel. Nothing is read from the SD card:
+ *   - Background: solid sky color
+ *   - Stars: procedurally placed, scroll left and twinkle
+ *   - Rainbow: six stepped stripes generated per frame (see tools/make_rainbow.py)
+ *   - Cat: 4 bpp sprites embedded in flash (src/nyan_sprite_data.c)
+ *
+ * Output pixels are panel-ready RGB565 (Swap+Invert applied).
+ */
+
+#define NYAN_SCENE_WIDTH   320
+#define NYAN_SCENE_HEIGHT  240
+
+/**
+ * @brief Prepare color tables (call once before composing)
+ */
+void nyan_compositor_init(void);
+
+/**
+ * @brief Display time of one frame in milliseconds (source GIF delay)
+ */
+uint32_t nyan_compositor_frame_ms(void);
+
+/**
+ * @brief Render lines [y0, y0 + lines) of a frame into a band buffer
+ * @param dst Output buffer, NYAN_SCENE_WIDTH * lines pixels
+ * @param y0 First scene line of the band
+ * @param lines Number of lines in the band
+ * @param frame Animation frame counter (free-running)
+ */
+void nyan_compose_band(uint16_t *dst, uint16_t y0, uint16_t lines, uint32_t frame);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NYAN_COMPOSITOR_H
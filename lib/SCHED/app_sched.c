@@ -0,0 +1,143 @@
+#include "app_sched.h"
+#include <stdatomic.h>
+#include "freertos/queue.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+
+static const char *TAG = "APP_SCHED";
+
+struct app_job {
+    const char *name;
+    app_job_fn_t fn;
+    void *ctx;
+    uint32_t period_ms;
+    esp_timer_handle_t timer;
+    atomic_bool queued;         // In the queue; cleared just before the job runs
+    int64_t queued_us;          // When it was queued (for the dispatch delay)
+    // Stats (loop task only)
+    uint32_t runs;
+    uint64_t total_us;
+    uint32_t max_us;
+    uint32_t max_delay_us;      // Longest time between queueing and running
+};
+
+static app_job_t jobs[APP_SCHED_MAX_JOBS];
+static int job_count = 0;
+static QueueHandle_t job_queue = NULL;
+
+// Loop accounting: time spent in jobs vs. the whole measurement window
+static int64_t stats_start_us = 0;
+static uint64_t busy_us = 0;
+
+static bool post(app_job_t *job) {
+    bool expected = false;
+    if (!atomic_compare_exchange_strong(&job->queued, &expected, true)) {
+        return true;  // Already queued: this period coalesces with it
+    }
+    job->queued_us = esp_timer_get_time();
+    if (xQueueSend(job_queue, &job, 0) != pdTRUE) {
+        atomic_store(&job->queued, false);
+        return false;
+    }
+    return true;
+}
+
+// esp_timer task context: hand the job to the loop, don't run it here
+static void timer_cb(void *arg) {
+    post((app_job_t *)arg);
+}
+
+bool app_sched_init(void) {
+    if (job_queue != NULL) {
+        return true;
+    }
+    job_queue = xQueueCreate(APP_SCHED_QUEUE_LEN, sizeof(app_job_t *));
+    stats_start_us = esp_timer_get_time();
+    return job_queue != NULL;
+}
+
+app_job_t* app_sched_add(const char* name, app_job_fn_t fn, void* ctx, uint32_t period_ms) {
+    if (job_queue == NULL || fn == NULL || job_count >= APP_SCHED_MAX_JOBS) {
+        ESP_LOGE(TAG, "Cannot add job %s", name);
+        return NULL;
+    }
+
+    app_job_t *job = &jobs[job_count];
+    job->name = name;
+    job->fn = fn;
+    job->ctx = ctx;
+    job->period_ms = period_ms;
+    atomic_init(&job->queued, false);
+
+    esp_timer_create_args_t args = {
+        .callback = timer_cb,
+        .arg = job,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = name,
+        .skip_unhandled_events = true,  // Missed periods while asleep collapse into one
+    };
+    if (esp_timer_create(&args, &job->timer) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create timer for %s", name);
+        return NULL;
+    }
+    if (period_ms > 0 && esp_timer_start_periodic(job->timer, (uint64_t)period_ms * 1000) != ESP_OK) {
+        esp_timer_delete(job->timer);
+        return NULL;
+    }
+
+    job_count++;
+    return job;
+}
+
+bool app_sched_start_once(app_job_t* job, uint32_t delay_ms) {
+    if (job == NULL) {
+        return false;
+    }
+    esp_timer_stop(job->timer);  // Not running is fine
+    return esp_timer_start_once(job->timer, (uint64_t)delay_ms * 1000) == ESP_OK;
+}
+
+bool app_sched_trigger(app_job_t* job) {
+    return job != NULL && job_queue != NULL && post(job);
+}
+
+uint32_t app_sched_run(TickType_t max_wait) {
+    app_job_t *job;
+    uint32_t ran = 0;
+
+    // Block for the first job, then drain whatever else is due without waiting
+    TickType_t wait = max_wait;
+    while (xQueueReceive(job_queue, &job, wait) == pdTRUE) {
+        wait = 0;
+        atomic_store(&job->queued, false);  // A trigger from now on queues it again
+
+        int64_t start = esp_timer_get_time();
+        job->fn(job->ctx);
+        int64_t end = esp_timer_get_time();
+
+        uint32_t run_us = (uint32_t)(end - start);
+        uint32_t delay_us = (uint32_t)(start - job->queued_us);
+        job->runs++;
+        job->total_us += run_us;
+        if (run_us > job->max_us) job->max_us = run_us;
+        if (delay_us > job->max_delay_us) job->max_delay_us = delay_us;
+        busy_us += run_us;
+        ran++;
+    }
+    return ran;
+}
+
+void app_sched_log_stats(void) {
+    int64_t window_us = esp_timer_get_time() - stats_start_us;
+    uint32_t busy_pm = window_us > 0 ? (uint32_t)(busy_us * 1000 / (uint64_t)window_us) : 0;
+    ESP_LOGI(TAG, "Jobs busy %lu.%lu%% of %lld ms", (unsigned long)(busy_pm / 10),
+             (unsigned long)(busy_pm % 10), (long long)(window_us / 1000));
+
+    for (int i = 0; i < job_count; i++) {
+        const app_job_t *job = &jobs[i];
+        ESP_LOGI(TAG, "  %-10s %6lu runs, avg %5lu us, max %6lu us, max delay %6lu us",
+                 job->name, (unsigned long)job->runs,
+                 (unsigned long)(job->runs ? job->total_us / job->runs : 0),
+                 (unsigned long)job->max_us, (unsigned long)job->max_delay_us);
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef APP_SCHED_H
+#define APP_SCHED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Event-driven application scheduler
+ *
+ * Periodic and one-shot jobs run on the task that calls app_sched_run()
+ * (the app_main loop), never in timer context. Each job owns an esp_timer.
+ * When the timer fires, its callback only posts the job to a FreeRTOS
+ * queue. app_sched_run() blocks on that queue, so the loop sleeps until a job
+ * is due, another task triggers one, or the caller's own deadline passes
+ * (e.g. LVGL's next timer). A job that is already queued is not queued again;
+ * a slow loop therefore coalesces missed periods instead of building a
+ * backlog.
+ *
+ * Adding a job costs one esp_timer and nothing per loop iteration.
+ */
+
+#define APP_SCHED_MAX_JOBS    8
+#define APP_SCHED_QUEUE_LEN   APP_SCHED_MAX_JOBS  // A job is queued at most once
+
+typedef void (*app_job_fn_t)(void *ctx);
+typedef struct app_job app_job_t;
+
+/**
+ * @brief Create the event queue (call once, before adding jobs)
+ * @return true on success
+ */
+bool app_sched_init(void);
+
+/**
+ * @brief Register a job
+ * @param name Short static name for the stats log
+ * @param fn Job function, run on the app_sched_run() task
+ * @param ctx Passed to fn
+ * @param period_ms Period for a periodic job (started immediately), or 0 for
+ *                  a job run only by app_sched_start_once() / app_sched_trigger()
+ * @return Job handle, or NULL if the table is full or the timer could not be created
+ */
+app_job_t* app_sched_add(const char* name, app_job_fn_t fn, void* ctx, uint32_t period_ms);
+
+/**
+ * @brief (Re)arm a job to run once after delay_ms (replaces a pending deadline)
+ */
+bool app_sched_start_once(app_job_t* job, uint32_t delay_ms);
+
+/**
+ * @brief Run a job as soon as possible (safe from any task; coalesced)
+ */
+bool app_sched_trigger(app_job_t* job);
+
+/**
+ * @brief Wait for due jobs and run them
+ * @param max_wait Longest time to block when nothing is due
+ * @return Number of jobs run
+ */
+uint32_t app_sched_run(TickType_t max_wait);
+
+/**
+ * @brief Log per-job run counts and times, and the share of time the loop was busy
+ */
+void app_sched_log_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APP_SCHED_H
@@ -0,0 +1,444 @@
+#include "sd_cache.h"
+#include "sd_spi.h"
+#include "dma_buf.h"
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_memory_utils.h"
+
+static const char *TAG = "SD_CACHE";
+
+#define NO_BLOCK UINT32_MAX
+
+typedef enum {
+    BLOCK_EMPTY = 0,
+    BLOCK_LOADING,          // Being read from the card; data not usable yet
+    BLOCK_VALID,
+} block_state_t;
+
+typedef struct {
+    uint8_t *data;          // SD_CACHE_BLOCK_SIZE bytes, DMA-capable (data of buf)
+    dma_buf_t *buf;
+    uint32_t block;         // Card sector / SD_CACHE_BLOCK_SECTORS
+    uint32_t last_used;
+    uint32_t generation;    // Cache generation the load was started in
+    uint8_t state;
+    bool prefetched;        // Loaded ahead and not read yet
+} cache_block_t;
+
+static cache_block_t blocks[SD_CACHE_MAX_BLOCKS];
+static sd_cache_config_t cache_config;
+static sd_cache_stats_t stats;
+static bool cache_ready = false;
+static uint32_t use_clock = 0;
+static volatile uint32_t generation = 0;  // Bumped by sd_cache_invalidate()
+
+static SemaphoreHandle_t cache_lock = NULL;   // Block table, stats and copies out
+static SemaphoreHandle_t io_lock = NULL;      // Card reads
+static SemaphoreHandle_t block_loaded = NULL; // Given whenever a load finishes
+
+// Sequential stream detection and the pending read-ahead request
+static uint32_t last_block = NO_BLOCK;
+static uint32_t streak = 0;
+static uint32_t prefetch_from = NO_BLOCK;
+static sdmmc_card_t *prefetch_card = NULL;
+static TaskHandle_t prefetch_task = NULL;
+static volatile bool prefetch_stop = false;   // Set by sd_cache_deinit()
+static volatile bool prefetch_done = false;   // Task has exited
+
+// Caller holds cache_lock
+static int find_block(uint32_t block) {
+    for (int i = 0; i < cache_config.block_count; i++) {
+        if (blocks[i].state != BLOCK_EMPTY && blocks[i].block == block) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Free slot, else the least recently used valid one; -1 if all are loading.
+// Caller holds cache_lock.
+static int pick_victim(void) {
+    int victim = -1;
+    for (int i = 0; i < cache_config.block_count; i++) {
+        if (blocks[i].state == BLOCK_EMPTY) {
+            return i;
+        }
+        if (blocks[i].state == BLOCK_VALID &&
+            (victim < 0 || blocks[i].last_used < blocks[victim].last_used)) {
+            victim = i;
+        }
+    }
+    if (victim >= 0 && blocks[victim].prefetched) {
+        stats.prefetch_wasted++;
+    }
+    return victim;
+}
+
+// Claim a slot for block and mark it loading; caller holds cache_lock
+static void claim(int slot, uint32_t block, bool prefetched) {
+    blocks[slot].block = block;
+    blocks[slot].state = BLOCK_LOADING;
+    blocks[slot].prefetched = prefetched;
+    blocks[slot].generation = generation;
+    blocks[slot].last_used = ++use_clock;
+}
+
+// Read a claimed slot from the card (called without cache_lock)
+static bool load(sdmmc_card_t *card, int slot) {
+    cache_block_t *b = &blocks[slot];
+    uint32_t first = b->block * SD_CACHE_BLOCK_SECTORS;
+
+    bool ok = false;
+    xSemaphoreTake(io_lock, portMAX_DELAY);
+    // Skip the read if the cache was invalidated (card unmounting) meanwhile
+    if (b->generation == generation) {
+        // Clip the last block to the card size
+        uint32_t capacity = (uint32_t)card->csd.capacity;
+        uint32_t count = SD_CACHE_BLOCK_SECTORS;
+        if (first + count > capacity) {
+            count = first < capacity ? capacity - first : 0;
+        }
+        esp_err_t ret = count ? sd_read_sectors(b->data, first, count) : ESP_ERR_INVALID_SIZE;
+        ok = (ret == ESP_OK);
+        if (!ok) {
+            ESP_LOGE(TAG, "Block %lu read failed: %s", (unsigned long)b->block, esp_err_to_name(ret));
+        }
+    }
+    xSemaphoreGive(io_lock);
+
+    xSemaphoreTake(cache_lock, portMAX_DELAY);
+    b->state = (ok && b->generation == generation) ? BLOCK_VALID : BLOCK_EMPTY;
+    xSemaphoreGive(cache_lock);
+    xSemaphoreGive(block_loaded);
+    return ok;
+}
+
+// Load blocks ahead of the stream while the reader is busy with the current one
+static void prefetch_task_fn(void *arg) {
+    (void)arg;
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (prefetch_stop) {
+            break;
+        }
+
+        xSemaphoreTake(cache_lock, portMAX_DELAY);
+        uint32_t from = prefetch_from;
+        sdmmc_card_t *card = prefetch_card;
+        uint32_t gen = generation;
+        xSemaphoreGive(cache_lock);
+
+        for (uint32_t block = from; block < from + cache_config.prefetch_blocks; block++) {
+            xSemaphoreTake(cache_lock, portMAX_DELAY);
+            int slot = -1;
+            if (gen == generation && find_block(block) < 0) {
+                slot = pick_victim();
+                if (slot >= 0) {
+                    claim(slot, block, true);
+                }
+            }
+            xSemaphoreGive(cache_lock);
+
+            if (slot >= 0 && load(card, slot)) {
+                xSemaphoreTake(cache_lock, portMAX_DELAY);
+                stats.prefetched++;
+                xSemaphoreGive(cache_lock);
+            }
+        }
+    }
+
+    prefetch_done = true;
+    vTaskDelete(NULL);
+}
+
+bool sd_cache_init(const sd_cache_config_t* config) {
+    if (config == NULL || cache_ready) {
+        return cache_ready;
+    }
+
+    cache_config = *config;
+    if (cache_config.block_count < 2) {
+        cache_config.block_count = 2;
+    }
+    if (cache_config.block_count > SD_CACHE_MAX_BLOCKS) {
+        cache_config.block_count = SD_CACHE_MAX_BLOCKS;
+    }
+    if (cache_config.prefetch_blocks >= cache_config.block_count) {
+        cache_config.prefetch_blocks = cache_config.block_count - 1;
+    }
+
+    // SD DMA needs internal, aligned memory
+    for (int i = 0; i < cache_config.block_count; i++) {
+        blocks[i].buf = dma_buf_alloc(SD_CACHE_BLOCK_SIZE, "sd_cache");
+        blocks[i].data = dma_buf_data(blocks[i].buf);
+        if (blocks[i].data == NULL) {
+            ESP_LOGE(TAG, "Failed to allocate block %d", i);
+            goto fail;
+        }
+    }
+
+    cache_lock = xSemaphoreCreateMutex();
+    io_lock = xSemaphoreCreateMutex();
+    block_loaded = xSemaphoreCreateBinary();
+    if (cache_lock == NULL || io_lock == NULL || block_loaded == NULL) {
+        goto fail;
+    }
+
+    prefetch_stop = false;
+    prefetch_done = false;
+    if (cache_config.prefetch_blocks > 0 &&
+        xTaskCreatePinnedToCore(prefetch_task_fn, "sd_prefetch", 3072, NULL,
+                                cache_config.task_priority, &prefetch_task,
+                                cache_config.task_core) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create prefetch task");
+        goto fail;
+    }
+
+    cache_ready = true;
+    ESP_LOGI(TAG, "Block cache ready: %d x %d KB, read-ahead %d blocks",
+             cache_config.block_count, SD_CACHE_BLOCK_SIZE / 1024, cache_config.prefetch_blocks);
+    return true;
+
+fail:
+    for (int i = 0; i < SD_CACHE_MAX_BLOCKS; i++) {
+        dma_buf_unref(blocks[i].buf);
+        blocks[i].buf = NULL;
+        blocks[i].data = NULL;
+    }
+    if (cache_lock) vSemaphoreDelete(cache_lock);
+    if (io_lock) vSemaphoreDelete(io_lock);
+    if (block_loaded) vSemaphoreDelete(block_loaded);
+    cache_lock = io_lock = block_loaded = NULL;
+    return false;
+}
+
+void sd_cache_deinit(void) {
+    if (!cache_ready) {
+        return;
+    }
+
+    // Raw reads go straight to the card from here on
+    cache_ready = false;
+    if (prefetch_task != NULL) {
+        prefetch_stop = true;
+        xTaskNotifyGive(prefetch_task);
+        while (!prefetch_done) {
+            vTaskDelay(pdMS_TO_TICKS(10));
+        }
+        prefetch_task = NULL;
+    }
+
+    for (int i = 0; i < SD_CACHE_MAX_BLOCKS; i++) {
+        dma_buf_unref(blocks[i].buf);
+        memset(&blocks[i], 0, sizeof(cache_block_t));
+    }
+    vSemaphoreDelete(cache_lock);
+    vSemaphoreDelete(io_lock);
+    vSemaphoreDelete(block_loaded);
+    cache_lock = io_lock = block_loaded = NULL;
+    last_block = NO_BLOCK;
+    streak = 0;
+    prefetch_card = NULL;
+    ESP_LOGI(TAG, "Block cache freed");
+}
+
+bool sd_cache_enabled(void) {
+    return cache_ready;
+}
+
+// Track consecutive block access and kick the prefetch task; caller holds cache_lock
+static void note_access(sdmmc_card_t *card, uint32_t block) {
+    if (block == last_block) {
+        return;
+    }
+    streak = (last_block != NO_BLOCK && block == last_block + 1) ? streak + 1 : 1;
+    last_block = block;
+
+    if (streak >= SD_CACHE_SEQ_THRESHOLD && prefetch_task != NULL) {
+        prefetch_from = block + 1;
+        prefetch_card = card;
+        xTaskNotifyGive(prefetch_task);
+    }
+}
+
+// Copy part of one block, loading it on demand
+static bool read_block(sdmmc_card_t *card, uint32_t block, uint32_t offset, uint8_t *dst, uint32_t len) {
+    bool counted = false;
+
+    while (true) {
+        xSemaphoreTake(cache_lock, portMAX_DELAY);
+        int slot = find_block(block);
+
+        if (slot >= 0 && blocks[slot].state == BLOCK_VALID) {
+            memcpy(dst, blocks[slot].data + offset, len);
+            blocks[slot].last_used = ++use_clock;
+            if (blocks[slot].prefetched) {
+                blocks[slot].prefetched = false;
+                stats.prefetch_used++;
+            }
+            if (!counted) {
+                stats.hits++;
+            }
+            note_access(card, block);
+            xSemaphoreGive(cache_lock);
+            return true;
+        }
+
+        if (slot >= 0) {
+            // Prefetch in flight - wait for it instead of reading twice
+            if (!counted) {
+                stats.waits++;
+                counted = true;
+            }
+            xSemaphoreGive(cache_lock);
+            xSemaphoreTake(block_loaded, pdMS_TO_TICKS(10));
+            continue;
+        }
+
+        slot = pick_victim();
+        if (slot < 0) {
+            xSemaphoreGive(cache_lock);
+            xSemaphoreTake(block_loaded, pdMS_TO_TICKS(10));
+            continue;
+        }
+        claim(slot, block, false);
+        if (!counted) {
+            stats.misses++;
+            counted = true;
+        }
+        xSemaphoreGive(cache_lock);
+
+        if (!load(card, slot)) {
+            return false;
+        }
+    }
+}
+
+// Whole sectors from pos (sector-aligned) that are not cached, up to
+// max_sectors; they can be read straight into the caller's buffer
+static uint32_t uncached_run(uint64_t pos, uint32_t max_sectors) {
+    uint32_t block = (uint32_t)(pos / SD_CACHE_BLOCK_SIZE);
+    uint32_t sectors = (uint32_t)((SD_CACHE_BLOCK_SIZE - pos % SD_CACHE_BLOCK_SIZE) / 512);
+    uint32_t run = 0;
+
+    xSemaphoreTake(cache_lock, portMAX_DELAY);
+    while (run < max_sectors && find_block(block) < 0) {
+        run += sectors;
+        sectors = SD_CACHE_BLOCK_SECTORS;
+        block++;
+    }
+    xSemaphoreGive(cache_lock);
+    return run < max_sectors ? run : max_sectors;
+}
+
+// Read sectors from the card into the caller's buffer, skipping the blocks
+static bool read_direct(uint8_t *dst, uint32_t sector, uint32_t count) {
+    xSemaphoreTake(io_lock, portMAX_DELAY);  // sd_cache_invalidate() waits for this too
+    esp_err_t ret = sd_read_sectors(dst, sector, count);
+    xSemaphoreGive(io_lock);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Direct read of %lu sectors at %lu failed: %s",
+                 (unsigned long)count, (unsigned long)sector, esp_err_to_name(ret));
+        return false;
+    }
+
+    xSemaphoreTake(cache_lock, portMAX_DELAY);
+    stats.bypassed++;
+    xSemaphoreGive(cache_lock);
+    return true;
+}
+
+bool sd_cache_read(sdmmc_card_t* card, uint32_t sector, uint32_t skip, void* buffer, uint32_t size) {
+    if (!cache_ready || card == NULL || buffer == NULL) {
+        return false;
+    }
+
+    uint8_t *dst = buffer;
+    uint64_t pos = (uint64_t)sector * 512 + skip;
+
+    // Large sector-aligned reads into DMA memory skip the memcpy out of a block
+    bool bypass = cache_config.bypass_min > 0 && size >= cache_config.bypass_min && skip == 0 &&
+                  esp_ptr_dma_capable(dst) && ((uintptr_t)dst & 3) == 0;
+
+    while (size > 0) {
+        if (bypass && size >= 512) {
+            uint32_t count = uncached_run(pos, size / 512);
+            if (count > 0) {
+                if (!read_direct(dst, (uint32_t)(pos / 512), count)) {
+                    return false;
+                }
+                dst += count * 512;
+                pos += count * 512;
+                size -= count * 512;
+                continue;
+            }
+        }
+
+        uint32_t block = (uint32_t)(pos / SD_CACHE_BLOCK_SIZE);
+        uint32_t offset = (uint32_t)(pos % SD_CACHE_BLOCK_SIZE);
+        uint32_t len = SD_CACHE_BLOCK_SIZE - offset;
+        if (len > size) {
+            len = size;
+        }
+        if (!read_block(card, block, offset, dst, len)) {
+            return false;
+        }
+        dst += len;
+        pos += len;
+        size -= len;
+    }
+    return true;
+}
+
+void sd_cache_invalidate(void) {
+    if (!cache_ready) {
+        return;
+    }
+
+    xSemaphoreTake(cache_lock, portMAX_DELAY);
+    generation++;
+    for (int i = 0; i < cache_config.block_count; i++) {
+        // Loading slots are released by their loader once it sees the new generation
+        if (blocks[i].state == BLOCK_VALID) {
+            blocks[i].state = BLOCK_EMPTY;
+        }
+        blocks[i].prefetched = false;
+    }
+    last_block = NO_BLOCK;
+    streak = 0;
+    prefetch_card = NULL;
+    xSemaphoreGive(cache_lock);
+
+    // Wait out any card read already in progress
+    xSemaphoreTake(io_lock, portMAX_DELAY);
+    xSemaphoreGive(io_lock);
+}
+
+void sd_cache_get_stats(sd_cache_stats_t* out) {
+    if (out == NULL) {
+        return;
+    }
+    if (!cache_ready) {
+        memset(out, 0, sizeof(sd_cache_stats_t));
+        return;
+    }
+    xSemaphoreTake(cache_lock, portMAX_DELAY);
+    *out = stats;
+    xSemaphoreGive(cache_lock);
+}
+
+void sd_cache_log_stats(void) {
+    sd_cache_stats_t s;
+    sd_cache_get_stats(&s);
+
+    uint32_t reads = s.hits + s.misses + s.waits;
+    ESP_LOGI(TAG, "Hits: %lu / %lu (%lu%%), waits: %lu, prefetched: %lu (used %lu, wasted %lu), bypassed: %lu",
+             (unsigned long)s.hits, (unsigned long)reads,
+             (unsigned long)(reads ? s.hits * 100 / reads : 0),
+             (unsigned long)s.waits, (unsigned long)s.prefetched,
+             (unsigned long)s.prefetch_used, (unsigned long)s.prefetch_wasted,
+             (unsigned long)s.bypassed);
+}
@@ -0,0 +1,106 @@
+#ifndef SD_CACHE_H
+#define SD_CACHE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdmmc_cmd.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Block read-ahead cache for raw SD reads
+ *
+ * Card sectors are cached in N aligned 16 KB blocks (32 sectors), keyed by
+ * card address so every raw reader (sd_raw.h) shares them. When a reader
+ * walks consecutive blocks, a prefetch task loads the next blocks in the
+ * background, so a streaming reader usually finds its next chunk in RAM and
+ * only pays a memcpy.
+ *
+ * Blocks are replaced least recently used first. Statistics count demand
+ * hits/misses and how many prefetched blocks were used before eviction.
+ *
+ * Going through a block costs a memcpy out of it. With bypass_min set, a
+ * read of at least bypass_min bytes starting on a sector boundary into a
+ * DMA-capable, 4-byte aligned buffer skips the cache instead: its whole
+ * sectors that are not already cached are DMA'd straight into the caller's
+ * buffer (zero-copy), and only a partial last sector is copied from a block.
+ * Bypassed reads are not read ahead, so they suit readers that already
+ * overlap card reads with other work (e.g. the frame pipeline's reader task).
+ * Small or unaligned reads still get read-ahead.
+ */
+
+#define SD_CACHE_BLOCK_SIZE      (16 * 1024)
+#define SD_CACHE_BLOCK_SECTORS   (SD_CACHE_BLOCK_SIZE / 512)
+#define SD_CACHE_MAX_BLOCKS      16
+#define SD_CACHE_SEQ_THRESHOLD   2      // Consecutive blocks before read-ahead starts
+
+typedef struct {
+    uint8_t block_count;        // Cache blocks (2..SD_CACHE_MAX_BLOCKS), DMA-capable RAM
+    uint8_t prefetch_blocks;    // Blocks read ahead once streaming is detected (< block_count)
+    uint8_t task_core;          // Prefetch task core
+    uint8_t task_priority;
+    uint32_t bypass_min;        // Smallest read DMA'd straight to the caller (0 = never bypass)
+} sd_cache_config_t;
+
+typedef struct {
+    uint32_t hits;              // Demand reads served from RAM
+    uint32_t misses;            // Demand reads that went to the card
+    uint32_t waits;             // Demand reads that waited for an in-flight prefetch
+    uint32_t prefetched;        // Blocks loaded by the prefetch task
+    uint32_t prefetch_used;     // Prefetched blocks later read
+    uint32_t prefetch_wasted;   // Prefetched blocks evicted unread
+    uint32_t bypassed;          // Card reads DMA'd straight into the caller's buffer
+} sd_cache_stats_t;
+
+/**
+ * @brief Allocate the cache blocks and start the prefetch task
+ * @param config Cache configuration (copied)
+ * @return true on success, false on failure (raw reads then go straight to the card)
+ */
+bool sd_cache_init(const sd_cache_config_t* config);
+
+/**
+ * @brief Stop the prefetch task and free the blocks (call with no reads in progress)
+ *
+ * Raw reads go straight to the card afterwards; sd_cache_init() starts it again.
+ */
+void sd_cache_deinit(void);
+
+/**
+ * @brief Whether the cache is initialized
+ */
+bool sd_cache_enabled(void);
+
+/**
+ * @brief Read bytes from a run of contiguous card sectors through the cache
+ * @param card Mounted card
+ * @param sector First card sector
+ * @param skip Byte offset into the first sector
+ * @param buffer Destination (DMA-capable and 4-byte aligned to allow a bypass)
+ * @param size Bytes to read
+ * @return true on success, false on card error
+ */
+bool sd_cache_read(sdmmc_card_t* card, uint32_t sector, uint32_t skip, void* buffer, uint32_t size);
+
+/**
+ * @brief Drop all cached blocks and wait for in-flight reads (e.g. before unmount)
+ */
+void sd_cache_invalidate(void);
+
+/**
+ * @brief Copy the current statistics
+ */
+void sd_cache_get_stats(sd_cache_stats_t* stats);
+
+/**
+ * @brief Log hit rate and prefetch statistics
+ */
+void sd_cache_log_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SD_CACHE_H
@@ -0,0 +1,412 @@
+#include "sd_logger.h"
+#include "sd_spi.h"
+#include "sd_service.h"
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "ff.h"
+
+static const char *TAG = "SD_LOGGER";
+
+#define LOGGER_STACK_SIZE  4096
+#define LOGGER_PATH_LEN    72
+
+static sd_logger_config_t log_config;
+static sd_logger_stats_t stats;
+static TaskHandle_t logger_task = NULL;
+static volatile bool flush_requested = false;
+
+// Record ring: producers append under ring_mux, the logger task drains.
+// Offsets are free-running; the task reads [tail, head) outside the lock
+// since producers never touch unconsumed bytes.
+static uint8_t *ring = NULL;
+static uint32_t ring_head = 0;
+static uint32_t ring_tail = 0;
+static portMUX_TYPE ring_mux = portMUX_INITIALIZER_UNLOCKED;
+
+// Log file state (logger task only)
+static FIL log_file;
+static bool file_open = false;
+static uint8_t file_slot = 0;
+static uint32_t file_seq = 0;       // 0 = not resumed from the card yet
+static uint8_t *block = NULL;       // Block being filled, DMA-capable
+static uint32_t block_offset = 0;   // File offset of block
+static uint32_t block_fill = 0;
+static uint32_t block_written = 0;  // Bytes of block that reached the file
+static uint32_t block_header = 0;   // "# seq" line at the start of block (first block only)
+static bool block_dirty = false;    // Data added since the block was last written
+
+static bool slot_path(uint8_t slot, char *out, size_t size) {
+    char name[LOGGER_PATH_LEN];
+    snprintf(name, sizeof(name), "%s/res_%u.log", log_config.dir, slot);  // 8.3 (no LFN)
+    return sd_fatfs_path(name, out, size);
+}
+
+// Find the newest file from its "# seq N" header and continue after it.
+// Uses log_file (not open yet): a FIL holds a 4 KB sector buffer, too big
+// for the task stack.
+static void resume_sequence(void) {
+    uint32_t best_seq = 0;
+    uint8_t best_slot = log_config.max_files - 1;  // So the first file is slot 0
+
+    for (uint8_t slot = 0; slot < log_config.max_files; slot++) {
+        char path[LOGGER_PATH_LEN];
+        if (!slot_path(slot, path, sizeof(path)) || f_open(&log_file, path, FA_READ) != FR_OK) {
+            continue;
+        }
+        // FATFS string functions are disabled (CONFIG_FATFS_USE_STRFUNC_NONE),
+        // so read the header line as raw bytes
+        char line[32];
+        UINT got = 0;
+        unsigned long seq;
+        if (f_read(&log_file, line, sizeof(line) - 1, &got) == FR_OK) {
+            line[got] = '\0';
+            if (sscanf(line, "# seq %lu", &seq) == 1 && seq > best_seq) {
+                best_seq = seq;
+                best_slot = slot;
+            }
+        }
+        f_close(&log_file);
+    }
+
+    file_seq = best_seq;
+    file_slot = best_slot;
+}
+
+// Begin the first block of a new file: its header, then whatever never
+// reached the previous file (failed write, card removed). Oldest whole
+// records that no longer fit are dropped and counted.
+static void start_block(void) {
+    char header[24];
+    uint32_t header_len = snprintf(header, sizeof(header), "# seq %lu\n", (unsigned long)file_seq);
+    uint32_t start = block_written > block_header ? block_written : block_header;
+    uint8_t *pending = block + start;
+    uint32_t len = block_fill > start ? block_fill - start : 0;
+    uint32_t lost = 0;
+
+    while (header_len + len > SD_LOGGER_BLOCK_SIZE) {
+        uint8_t *end = memchr(pending, '\n', len);
+        uint32_t cut = end ? (uint32_t)(end - pending) + 1 : len;
+        pending += cut;
+        len -= cut;
+        lost++;
+    }
+    memmove(block + header_len, pending, len);
+    memcpy(block, header, header_len);
+    memset(block + header_len + len, 0, SD_LOGGER_BLOCK_SIZE - header_len - len);
+
+    if (lost > 0) {
+        taskENTER_CRITICAL(&ring_mux);
+        stats.dropped += lost;
+        taskEXIT_CRITICAL(&ring_mux);
+    }
+    if (len > 0) {
+        ESP_LOGW(TAG, "Carried %lu unwritten bytes into the new file", (unsigned long)len);
+    }
+
+    block_offset = 0;
+    block_fill = header_len + len;
+    block_written = 0;
+    block_header = header_len;
+    block_dirty = true;
+}
+
+// Preallocate, zero and start the next file in the rotation
+static bool start_next_file(void) {
+    char path[LOGGER_PATH_LEN];
+    if (!sd_fatfs_path(log_config.dir, path, sizeof(path))) {
+        return false;
+    }
+    FRESULT fr = f_mkdir(path);
+    if (fr != FR_OK && fr != FR_EXIST) {
+        ESP_LOGE(TAG, "Cannot create %s (%d)", log_config.dir, fr);
+        return false;
+    }
+
+    if (file_seq == 0) {
+        resume_sequence();
+    }
+    file_slot = (file_slot + 1) % log_config.max_files;
+    file_seq++;
+
+    if (!slot_path(file_slot, path, sizeof(path)) ||
+        f_open(&log_file, path, FA_READ | FA_WRITE | FA_OPEN_ALWAYS) != FR_OK) {
+        ESP_LOGE(TAG, "Cannot open log file %u", file_slot);
+        return false;
+    }
+
+    // Contiguous allocation up front: later block writes never touch the FAT
+    fr = f_truncate(&log_file);
+    if (fr == FR_OK) {
+        fr = f_expand(&log_file, log_config.file_size, 1);
+        if (fr != FR_OK) {
+            ESP_LOGW(TAG, "No contiguous space for %lu bytes - allocating fragmented",
+                     (unsigned long)log_config.file_size);
+            fr = f_lseek(&log_file, log_config.file_size);
+        }
+    }
+
+    // Zero the file so unused space reads as empty after a power loss. The
+    // zeros come from a temporary buffer: block may still hold unwritten records.
+    uint8_t *zeros = heap_caps_calloc(1, SD_LOGGER_BLOCK_SIZE, MALLOC_CAP_DMA);
+    if (zeros == NULL) {
+        fr = FR_NOT_ENOUGH_CORE;
+    }
+    if (fr == FR_OK) {
+        fr = f_lseek(&log_file, 0);
+    }
+    for (uint32_t pos = 0; fr == FR_OK && pos < log_config.file_size; pos += SD_LOGGER_BLOCK_SIZE) {
+        UINT written;
+        fr = f_write(&log_file, zeros, SD_LOGGER_BLOCK_SIZE, &written);
+        if (fr == FR_OK && written != SD_LOGGER_BLOCK_SIZE) {
+            fr = FR_DENIED;
+        }
+    }
+    heap_caps_free(zeros);
+    if (fr == FR_OK) {
+        fr = f_sync(&log_file);
+    }
+    if (fr != FR_OK) {
+        ESP_LOGE(TAG, "Failed to preallocate log file %u (%d)", file_slot, fr);
+        f_close(&log_file);
+        return false;
+    }
+
+    start_block();
+    file_open = true;
+    ESP_LOGI(TAG, "Logging to %s/res_%u.log (seq %lu, %lu KB)", log_config.dir, file_slot,
+             (unsigned long)file_seq, (unsigned long)(log_config.file_size / 1024));
+    return true;
+}
+
+// The open file holds a reference on the volume (sd_service_acquire())
+static bool open_next_file(void) {
+    if (!sd_service_acquire()) {
+        return false;
+    }
+    if (!start_next_file()) {
+        sd_service_release();
+        return false;
+    }
+    return true;
+}
+
+static void close_file(void) {
+    if (file_open) {
+        f_close(&log_file);
+        file_open = false;
+        sd_service_release();
+    }
+}
+
+// Write the current block (zero-padded) at its aligned offset
+static bool write_block(void) {
+    UINT written = 0;
+    FRESULT fr = f_lseek(&log_file, block_offset);
+    if (fr == FR_OK) {
+        fr = f_write(&log_file, block, SD_LOGGER_BLOCK_SIZE, &written);
+    }
+    if (fr != FR_OK || written != SD_LOGGER_BLOCK_SIZE) {
+        ESP_LOGE(TAG, "Block write at %lu failed (%d)", (unsigned long)block_offset, fr);
+        stats.write_errors++;
+        close_file();
+        return false;
+    }
+    block_written = block_fill;
+    block_dirty = false;
+    return true;
+}
+
+// Move ring data into blocks, writing each block as it fills
+static bool drain_ring(void) {
+    while (true) {
+        taskENTER_CRITICAL(&ring_mux);
+        uint32_t head = ring_head;
+        taskEXIT_CRITICAL(&ring_mux);
+        if (head == ring_tail) {
+            return true;
+        }
+
+        uint32_t pos = ring_tail % log_config.ring_size;
+        uint32_t len = head - ring_tail;
+        if (len > log_config.ring_size - pos) {
+            len = log_config.ring_size - pos;  // Up to the ring wrap
+        }
+        if (len > SD_LOGGER_BLOCK_SIZE - block_fill) {
+            len = SD_LOGGER_BLOCK_SIZE - block_fill;
+        }
+        memcpy(block + block_fill, ring + pos, len);
+        block_fill += len;
+        block_dirty = true;
+
+        taskENTER_CRITICAL(&ring_mux);
+        ring_tail += len;
+        taskEXIT_CRITICAL(&ring_mux);
+
+        if (block_fill == SD_LOGGER_BLOCK_SIZE) {
+            if (!write_block()) {
+                return false;
+            }
+            stats.blocks++;
+            block_offset += SD_LOGGER_BLOCK_SIZE;
+            block_fill = 0;
+            block_written = 0;
+            block_header = 0;
+            memset(block, 0, SD_LOGGER_BLOCK_SIZE);
+
+            if (block_offset >= log_config.file_size) {
+                f_sync(&log_file);
+                close_file();
+                stats.rotations++;
+                if (!open_next_file()) {
+                    return false;
+                }
+            }
+        }
+    }
+}
+
+static void logger_task_fn(void *arg) {
+    (void)arg;
+    int64_t last_sync = esp_timer_get_time();
+
+    while (true) {
+        if (!file_open) {
+            // Records stay in the ring until a card is mounted
+            if (!sd_service_wait_ready(pdMS_TO_TICKS(1000)) || !open_next_file()) {
+                vTaskDelay(pdMS_TO_TICKS(1000));
+                continue;
+            }
+        }
+
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(log_config.sync_interval_ms));
+        if (sd_service_state() != SD_STATE_MOUNTED) {
+            // Card removed: close the file so the service can unmount; new
+            // records wait in the ring for the next card
+            ESP_LOGW(TAG, "SD card removed - closing log file");
+            close_file();
+            file_seq = 0;  // The next card has its own sequence and slots
+            continue;
+        }
+        if (!drain_ring()) {
+            continue;
+        }
+
+        int64_t now = esp_timer_get_time();
+        if (flush_requested || now - last_sync >= (int64_t)log_config.sync_interval_ms * 1000) {
+            flush_requested = false;
+            last_sync = now;
+            if (block_dirty && !write_block()) {
+                continue;
+            }
+            if (f_sync(&log_file) != FR_OK) {
+                stats.write_errors++;
+                close_file();
+                continue;
+            }
+            stats.syncs++;
+        }
+    }
+}
+
+bool sd_logger_start(const sd_logger_config_t *config) {
+    if (config == NULL || config->dir == NULL || config->max_files == 0 ||
+        config->file_size < 2 * SD_LOGGER_BLOCK_SIZE || config->ring_size < SD_LOGGER_MAX_RECORD) {
+        return false;
+    }
+    if (logger_task != NULL) {
+        return true;
+    }
+
+    log_config = *config;
+    log_config.file_size -= log_config.file_size % SD_LOGGER_BLOCK_SIZE;
+
+    ring = heap_caps_malloc(log_config.ring_size, MALLOC_CAP_8BIT);
+    block = heap_caps_malloc(SD_LOGGER_BLOCK_SIZE, MALLOC_CAP_DMA);
+    if (ring == NULL || block == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate logger buffers");
+        goto fail;
+    }
+
+    if (xTaskCreate(logger_task_fn, "sd_logger", LOGGER_STACK_SIZE, NULL,
+                    log_config.task_priority, &logger_task) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create logger task");
+        goto fail;
+    }
+    return true;
+
+fail:
+    heap_caps_free(ring);
+    heap_caps_free(block);
+    ring = NULL;
+    block = NULL;
+    return false;
+}
+
+bool sd_logger_printf(const char *fmt, ...) {
+    if (ring == NULL) {
+        return false;
+    }
+
+    char record[SD_LOGGER_MAX_RECORD];
+    int len = snprintf(record, sizeof(record), "%lld ", (long long)(esp_timer_get_time() / 1000));
+    va_list args;
+    va_start(args, fmt);
+    int text = vsnprintf(record + len, sizeof(record) - len - 1, fmt, args);
+    va_end(args);
+    if (text < 0) {
+        return false;
+    }
+    len += text;
+    if (len > (int)sizeof(record) - 2) {
+        len = sizeof(record) - 2;  // Truncated
+    }
+    record[len++] = '\n';
+
+    bool ok;
+    uint32_t pending;
+    taskENTER_CRITICAL(&ring_mux);
+    ok = log_config.ring_size - (ring_head - ring_tail) >= (uint32_t)len;
+    if (ok) {
+        uint32_t pos = ring_head % log_config.ring_size;
+        uint32_t first = log_config.ring_size - pos;
+        if (first > (uint32_t)len) {
+            first = len;
+        }
+        memcpy(ring + pos, record, first);
+        memcpy(ring, record + first, len - first);
+        ring_head += len;
+        stats.records++;
+    } else {
+        stats.dropped++;
+    }
+    pending = ring_head - ring_tail;
+    taskEXIT_CRITICAL(&ring_mux);
+
+    // Wake the task only once a whole block is waiting
+    if (ok && pending >= SD_LOGGER_BLOCK_SIZE && pending - len < SD_LOGGER_BLOCK_SIZE) {
+        xTaskNotifyGive(logger_task);
+    }
+    return ok;
+}
+
+void sd_logger_flush(void) {
+    if (logger_task != NULL) {
+        flush_requested = true;
+        xTaskNotifyGive(logger_task);
+    }
+}
+
+void sd_logger_get_stats(sd_logger_stats_t *out) {
+    if (out == NULL) {
+        return;
+    }
+    taskENTER_CRITICAL(&ring_mux);
+    *out = stats;
+    taskEXIT_CRITICAL(&ring_mux);
+}
@@ -0,0 +1,90 @@
+#ifndef SD_LOGGER_H
+#define SD_LOGGER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Append-only result logger on the SD card
+ *
+ * Callers format a record into a RAM ring (a short critical section, never
+ * blocks on the card; records are dropped and counted if the ring is full).
+ * A low-priority task drains the ring into SD_LOGGER_BLOCK_SIZE blocks and
+ * writes them at block-aligned offsets of a log file that was preallocated
+ * contiguously (f_expand) and zero-filled when it was opened, so no write
+ * allocates clusters or touches the FAT. Each sync still rewrites the
+ * file's directory entry (timestamp), once per sync_interval_ms.
+ *
+ * A partly filled block is written padded with zeros at each sync and
+ * rewritten in place once it fills, so after a power loss the file holds
+ * everything up to the last sync. Syncs are batched every sync_interval_ms.
+ *
+ * Files rotate through <dir>/res_<n>.log (n < max_files, 8.3 names since
+ * long file names are disabled) by size; each starts with a "# seq N" line
+ * so the newest survives reboots. Trailing zero bytes are unused space.
+ * Records that did not reach a file (failed write, card removed) are
+ * carried into the next one.
+ *
+ * The open file holds a reference on the volume (sd_service_acquire()).
+ * When the card is removed the task closes it at its next wakeup (at most
+ * sync_interval_ms) so the service can unmount, and opens the next file once
+ * a card is mounted again, continuing that card's own sequence.
+ */
+
+#define SD_LOGGER_BLOCK_SIZE   4096
+#define SD_LOGGER_MAX_RECORD   160     // Longest record, including timestamp
+
+typedef struct {
+    const char *dir;            // Log directory, e.g. "/sdcard/logs"
+    uint32_t file_size;         // Preallocated bytes per file (multiple of the block size)
+    uint8_t max_files;          // Files kept before the oldest is reused
+    uint32_t ring_size;         // RAM ring bytes
+    uint32_t sync_interval_ms;  // Max time a record waits in RAM
+    uint8_t task_priority;
+} sd_logger_config_t;
+
+typedef struct {
+    uint32_t records;           // Records accepted into the ring
+    uint32_t dropped;           // Records lost because the ring was full
+    uint32_t blocks;            // Full blocks written
+    uint32_t syncs;
+    uint32_t rotations;
+    uint32_t write_errors;
+} sd_logger_stats_t;
+
+/**
+ * @brief Allocate the ring and start the logger task
+ *
+ * The task waits for the card (sd_service.h) before opening a file; records
+ * logged before then stay in the ring.
+ *
+ * @param config Logger configuration (copied)
+ * @return true on success, false on failure
+ */
+bool sd_logger_start(const sd_logger_config_t *config);
+
+/**
+ * @brief Append one record (timestamped, newline added); safe from any task
+ * @return false if the record was dropped
+ */
+bool sd_logger_printf(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+/**
+ * @brief Ask the logger task to write and sync everything pending now
+ */
+void sd_logger_flush(void);
+
+/**
+ * @brief Copy the current statistics
+ */
+void sd_logger_get_stats(sd_logger_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SD_LOGGER_H
@@ -0,0 +1,244 @@
+#include "sd_raw.h"
+#include "sd_spi.h"
+#include "sd_cache.h"
+#include <stdio.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "ff.h"
+#include "sdmmc_cmd.h"
+
+static const char *TAG = "SD_RAW";
+
+// Append a cluster run, merging it with the previous extent when adjacent
+static bool add_extent(sd_raw_file_t* file, uint32_t sector, uint32_t count) {
+    if (file->extent_count > 0) {
+        sd_raw_extent_t* last = &file->extents[file->extent_count - 1];
+        if (last->sector + last->count == sector) {
+            last->count += count;
+            return true;
+        }
+    }
+    if (file->extent_count == SD_RAW_MAX_EXTENTS) {
+        return false;
+    }
+    file->extents[file->extent_count].sector = sector;
+    file->extents[file->extent_count].count = count;
+    file->extent_count++;
+    return true;
+}
+
+// Build the fast-seek cluster link map (CONFIG_FATFS_USE_FASTSEEK): FatFs
+// follows the FAT chain and reads only FAT sectors, no file data. The map
+// holds (cluster count, first cluster) per fragment, terminated by 0.
+static bool map_clusters(sd_raw_file_t* file, FIL* fp) {
+    if (file->size == 0) {
+        return true;
+    }
+
+    DWORD clmt[2 * SD_RAW_MAX_EXTENTS + 2];
+    clmt[0] = sizeof(clmt) / sizeof(clmt[0]);
+    fp->cltbl = clmt;
+    FRESULT fr = f_lseek(fp, CREATE_LINKMAP);
+    fp->cltbl = NULL;
+    if (fr == FR_NOT_ENOUGH_CORE) {
+        ESP_LOGW(TAG, "File has more than %d fragments", SD_RAW_MAX_EXTENTS);
+        return false;
+    }
+    if (fr != FR_OK) {
+        return false;
+    }
+
+    FATFS* fs = fp->obj.fs;
+    for (const DWORD* frag = &clmt[1]; frag[0] != 0; frag += 2) {
+        if (frag[1] < 2) {
+            return false;
+        }
+        uint32_t sector = (uint32_t)fs->database + (frag[1] - 2) * fs->csize;
+        if (!add_extent(file, sector, frag[0] * fs->csize)) {
+            ESP_LOGW(TAG, "File has more than %d fragments", SD_RAW_MAX_EXTENTS);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool sd_raw_open(sd_raw_file_t* file, const char* path) {
+    if (file == NULL || path == NULL) {
+        return false;
+    }
+    memset(file, 0, sizeof(sd_raw_file_t));
+    file->cached_sector = UINT32_MAX;
+
+    sdmmc_card_t* card = sd_get_card();
+    if (card == NULL) {
+        return false;
+    }
+    if (card->csd.sector_size != SD_RAW_SECTOR_SIZE) {
+        ESP_LOGE(TAG, "Unsupported sector size %d", card->csd.sector_size);
+        return false;
+    }
+
+    char fpath[72];
+    if (!sd_fatfs_path(path, fpath, sizeof(fpath))) {
+        return false;
+    }
+
+    // A FIL embeds a sector buffer (4 KB with CONFIG_FATFS_SECTOR_4096), too
+    // big for the stack of the tasks that open frames
+    FIL* fp = heap_caps_malloc(sizeof(FIL), MALLOC_CAP_8BIT);
+    if (fp == NULL) {
+        return false;
+    }
+    bool mapped = false;
+    if (f_open(fp, fpath, FA_READ) == FR_OK) {
+        file->size = (uint32_t)f_size(fp);
+        mapped = map_clusters(file, fp);
+        f_close(fp);
+    }
+    heap_caps_free(fp);
+    if (!mapped) {
+        return false;
+    }
+
+    file->sector_buf = heap_caps_malloc(SD_RAW_SECTOR_SIZE, MALLOC_CAP_DMA);
+    if (file->sector_buf == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate sector buffer");
+        return false;
+    }
+
+    ESP_LOGD(TAG, "%s: %lu bytes in %d extent(s)", path, (unsigned long)file->size, file->extent_count);
+    return true;
+}
+
+// Map a file sector to its card sector and the number of contiguous sectors after it
+static bool locate(const sd_raw_file_t* file, uint32_t file_sector, uint32_t* card_sector, uint32_t* run) {
+    for (int i = 0; i < file->extent_count; i++) {
+        const sd_raw_extent_t* ext = &file->extents[i];
+        if (file_sector < ext->count) {
+            *card_sector = ext->sector + file_sector;
+            *run = ext->count - file_sector;
+            return true;
+        }
+        file_sector -= ext->count;
+    }
+    return false;
+}
+
+// Copy part of one file sector through the bounce buffer
+static bool read_partial(sd_raw_file_t* file, uint32_t file_sector,
+                         uint32_t skip, uint8_t* dst, uint32_t len) {
+    uint32_t card_sector, run;
+    if (!locate(file, file_sector, &card_sector, &run)) {
+        return false;
+    }
+    if (file->cached_sector != card_sector) {
+        if (sd_read_sectors(file->sector_buf, card_sector, 1) != ESP_OK) {
+            file->cached_sector = UINT32_MAX;
+            return false;
+        }
+        file->cached_sector = card_sector;
+    }
+    memcpy(dst, file->sector_buf + skip, len);
+    return true;
+}
+
+// Read through the block cache, one contiguous extent run at a time
+static bool read_cached(const sd_raw_file_t* file, sdmmc_card_t* card, uint32_t offset,
+                        uint8_t* dst, uint32_t left) {
+    while (left > 0) {
+        uint32_t card_sector, run;
+        if (!locate(file, offset / SD_RAW_SECTOR_SIZE, &card_sector, &run)) {
+            return false;
+        }
+        uint32_t skip = offset % SD_RAW_SECTOR_SIZE;
+        uint32_t len = run * SD_RAW_SECTOR_SIZE - skip;
+        if (len > left) {
+            len = left;
+        }
+        if (!sd_cache_read(card, card_sector, skip, dst, len)) {
+            return false;
+        }
+        dst += len;
+        offset += len;
+        left -= len;
+    }
+    return true;
+}
+
+uint32_t sd_raw_read(sd_raw_file_t* file, uint32_t offset, void* buffer, uint32_t size) {
+    sdmmc_card_t* card = sd_get_card();
+    if (file == NULL || file->sector_buf == NULL || buffer == NULL || card == NULL) {
+        return 0;
+    }
+    if (offset >= file->size) {
+        return 0;
+    }
+    if (size > file->size - offset) {
+        size = file->size - offset;
+    }
+
+    if (sd_cache_enabled()) {
+        return read_cached(file, card, offset, buffer, size) ? size : 0;
+    }
+
+    uint8_t* dst = buffer;
+    uint32_t left = size;
+    uint32_t sector = offset / SD_RAW_SECTOR_SIZE;
+    uint32_t skip = offset % SD_RAW_SECTOR_SIZE;
+
+    // Unaligned head
+    if (skip != 0) {
+        uint32_t len = SD_RAW_SECTOR_SIZE - skip;
+        if (len > left) {
+            len = left;
+        }
+        if (!read_partial(file, sector, skip, dst, len)) {
+            return 0;
+        }
+        dst += len;
+        left -= len;
+        sector++;
+    }
+
+    // Whole sectors: one multi-block read per contiguous run
+    while (left >= SD_RAW_SECTOR_SIZE) {
+        uint32_t card_sector, run;
+        if (!locate(file, sector, &card_sector, &run)) {
+            return 0;
+        }
+        uint32_t count = left / SD_RAW_SECTOR_SIZE;
+        if (count > run) {
+            count = run;
+        }
+        esp_err_t ret = sd_read_sectors(dst, card_sector, count);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Read of %lu sectors at %lu failed: %s",
+                     (unsigned long)count, (unsigned long)card_sector, esp_err_to_name(ret));
+            return 0;
+        }
+        dst += count * SD_RAW_SECTOR_SIZE;
+        left -= count * SD_RAW_SECTOR_SIZE;
+        sector += count;
+    }
+
+    // Partial tail
+    if (left > 0) {
+        if (!read_partial(file, sector, 0, dst, left)) {
+            return 0;
+        }
+    }
+
+    return size;
+}
+
+bool sd_raw_is_contiguous(const sd_raw_file_t* file) {
+    return file != NULL && file->extent_count <= 1;
+}
+
+void sd_raw_close(sd_raw_file_t* file) {
+    if (file != NULL && file->sector_buf != NULL) {
+        heap_caps_free(file->sector_buf);
+        file->sector_buf = NULL;
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef SD_RAW_H
+#define SD_RAW_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Raw-sector file reads (bypassing stdio, VFS and FATFS)
+ *
+ * sd_raw_open() walks the file's FAT cluster chain once (a FatFs fast-seek
+ * link map, which reads FAT sectors only) and keeps it as a short list of
+ * contiguous sector extents. Reads then go straight to
+ * sd_read_sectors() as multi-block transfers into the caller's buffer, so
+ * streaming a large asset runs at the card's raw throughput with no per-call
+ * FAT lookups or stdio copies.
+ *
+ * With the block cache running (sd_cache.h) reads are served from its
+ * read-ahead blocks instead, except large ones it bypasses (bypass_min).
+ * Otherwise only whole sectors are transferred directly; a partial
+ * first/last sector goes through a small internal sector buffer. For true
+ * zero-copy DMA, pass a DMA-capable, 4-byte aligned destination.
+ *
+ * The extent map is a snapshot: files must not be written while they are
+ * open here, and handles become unusable once the card is unmounted.
+ */
+
+#define SD_RAW_MAX_EXTENTS   8      // Fragments tracked per file (more = fall back to stdio)
+#define SD_RAW_SECTOR_SIZE   512
+
+typedef struct {
+    uint32_t sector;        // First card sector of the extent
+    uint32_t count;         // Sectors in the extent
+} sd_raw_extent_t;
+
+typedef struct {
+    sd_raw_extent_t extents[SD_RAW_MAX_EXTENTS];
+    uint8_t extent_count;
+    uint32_t size;          // File size in bytes
+    uint8_t *sector_buf;    // DMA-capable bounce for partial sectors
+    uint32_t cached_sector; // Card sector held in sector_buf (UINT32_MAX = none)
+} sd_raw_file_t;
+
+/**
+ * @brief Resolve a file's cluster chain for raw reads
+ * @param file Handle to initialize
+ * @param path File name relative to the card root, or a full "/sdcard/..." path
+ * @return true on success; false if the card is not mounted, the file is
+ *         missing or too fragmented (callers should fall back to fopen)
+ */
+bool sd_raw_open(sd_raw_file_t* file, const char* path);
+
+/**
+ * @brief Read bytes at any offset straight from the card
+ * @param file Open handle
+ * @param offset Byte offset in the file
+ * @param buffer Destination (DMA-capable and 4-byte aligned for direct transfers)
+ * @param size Bytes to read; clipped at end of file
+ * @return Bytes read (0 on error or at end of file)
+ */
+uint32_t sd_raw_read(sd_raw_file_t* file, uint32_t offset, void* buffer, uint32_t size);
+
+/**
+ * @brief Whether the file is a single contiguous extent
+ */
+bool sd_raw_is_contiguous(const sd_raw_file_t* file);
+
+/**
+ * @brief Release the handle's sector buffer
+ */
+void sd_raw_close(sd_raw_file_t* file);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SD_RAW_H
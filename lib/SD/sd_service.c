@@ -0,0 +1,154 @@
+#include "sd_service.h"
+#include "freertos/task.h"
+#include "freertos/event_groups.h"
+#include "esp_log.h"
+
+static const char *TAG = "SD_SERVICE";
+
+static sd_config_t service_config;
+static EventGroupHandle_t sd_events = NULL;
+static TaskHandle_t service_task = NULL;
+static volatile sd_state_t state = SD_STATE_NO_CARD;
+static sd_state_cb_t state_cb = NULL;
+static void* state_cb_ctx = NULL;
+
+// Volume references; state changes take the same lock so a reference is
+// never handed out once removal has been published
+static uint32_t users = 0;
+static portMUX_TYPE users_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static void set_state(sd_state_t new_state) {
+    if (new_state == state) {
+        return;
+    }
+    taskENTER_CRITICAL(&users_mux);
+    state = new_state;
+    taskEXIT_CRITICAL(&users_mux);
+    if (new_state == SD_STATE_MOUNTED) {
+        xEventGroupSetBits(sd_events, SD_SERVICE_READY_BIT);
+    } else {
+        xEventGroupClearBits(sd_events, SD_SERVICE_READY_BIT);
+    }
+
+    sd_state_cb_t cb = state_cb;
+    if (cb != NULL) {
+        cb(new_state, state_cb_ctx);
+    }
+}
+
+static uint32_t user_count(void) {
+    taskENTER_CRITICAL(&users_mux);
+    uint32_t count = users;
+    taskEXIT_CRITICAL(&users_mux);
+    return count;
+}
+
+// Wait for every user to close its files before the volume goes away
+static void wait_for_users(void) {
+    for (uint32_t waited_ms = 0; user_count() > 0; waited_ms += 10) {
+        if (waited_ms % 1000 == 0) {
+            ESP_LOGW(TAG, "Waiting for %lu SD user(s) to close their files", (unsigned long)user_count());
+        }
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+}
+
+static void service_task_fn(void* arg) {
+    (void)arg;
+    uint32_t backoff_ms = SD_SERVICE_RETRY_MIN_MS;
+    uint32_t failures = 0;
+
+    while (true) {
+        if (state != SD_STATE_MOUNTED) {
+            if (sd_init_config(&service_config)) {
+                backoff_ms = SD_SERVICE_RETRY_MIN_MS;
+                failures = 0;
+                set_state(SD_STATE_MOUNTED);
+                continue;
+            }
+            ESP_LOGW(TAG, "No SD card - retrying in %lu ms", (unsigned long)backoff_ms);
+            vTaskDelay(pdMS_TO_TICKS(backoff_ms));
+            backoff_ms = backoff_ms * 2 > SD_SERVICE_RETRY_MAX_MS ? SD_SERVICE_RETRY_MAX_MS : backoff_ms * 2;
+            continue;
+        }
+
+        // Mounted: a removed card stops answering SEND_STATUS
+        vTaskDelay(pdMS_TO_TICKS(SD_SERVICE_POLL_MS));
+        esp_err_t ret = sd_card_status();
+        if (ret == ESP_OK) {
+            failures = 0;
+            continue;
+        }
+        if (++failures < SD_SERVICE_REMOVE_FAILS) {
+            ESP_LOGW(TAG, "SD status check failed (%d/%d): %s",
+                     (int)failures, SD_SERVICE_REMOVE_FAILS, esp_err_to_name(ret));
+            continue;
+        }
+
+        // Tell users first, unmount once they have closed their files
+        ESP_LOGW(TAG, "SD card removed");
+        set_state(SD_STATE_REMOVED);
+        wait_for_users();
+        sd_unmount();
+    }
+}
+
+bool sd_service_start(const sd_config_t* config) {
+    if (config == NULL) {
+        return false;
+    }
+    if (service_task != NULL) {
+        return true;
+    }
+
+    service_config = *config;
+    sd_events = xEventGroupCreate();
+    if (sd_events == NULL) {
+        return false;
+    }
+
+    if (xTaskCreate(service_task_fn, "sd_service", SD_SERVICE_STACK_SIZE, NULL,
+                    SD_SERVICE_PRIORITY, &service_task) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create SD service task");
+        vEventGroupDelete(sd_events);
+        sd_events = NULL;
+        return false;
+    }
+    return true;
+}
+
+void sd_service_set_callback(sd_state_cb_t cb, void* ctx) {
+    state_cb_ctx = ctx;
+    state_cb = cb;
+}
+
+bool sd_service_wait_ready(TickType_t timeout) {
+    if (sd_events == NULL) {
+        return sd_mount();  // Service not started - card mounted directly (or not at all)
+    }
+    EventBits_t bits = xEventGroupWaitBits(sd_events, SD_SERVICE_READY_BIT, pdFALSE, pdTRUE, timeout);
+    return (bits & SD_SERVICE_READY_BIT) != 0;
+}
+
+sd_state_t sd_service_state(void) {
+    return state;
+}
+
+bool sd_service_acquire(void) {
+    taskENTER_CRITICAL(&users_mux);
+    // Without the service the card was mounted directly and never goes away
+    bool ok = (sd_events == NULL) ? sd_mount() : (state == SD_STATE_MOUNTED);
+    if (ok) {
+        users++;
+    }
+    taskEXIT_CRITICAL(&users_mux);
+    return ok;
+}
+
+void sd_service_release(void) {
+    taskENTER_CRITICAL(&users_mux);
+    if (users > 0) {
+        users--;
+    }
+    taskEXIT_CRITICAL(&users_mux);
+}
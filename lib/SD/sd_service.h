@@ -0,0 +1,93 @@
+#ifndef SD_SERVICE_H
+#define SD_SERVICE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "sd_spi.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Background SD mount service
+ *
+ * A low-priority task owns mounting so boot never waits on the card:
+ *   - No card / mount failure: retry with exponential backoff
+ *     (SD_SERVICE_RETRY_MIN_MS doubling up to SD_SERVICE_RETRY_MAX_MS)
+ *   - Mounted: probe the card with CMD13 every SD_SERVICE_POLL_MS; after
+ *     SD_SERVICE_REMOVE_FAILS failures in a row the card counts as removed,
+ *     so a single transient error does not unmount it
+ *   - Removed: publish SD_STATE_REMOVED, wait until every user has released
+ *     the volume (sd_service_release()), then unmount and go back to
+ *     retrying, so a reinserted card is picked up without a reboot
+ *
+ * Code that keeps files or raw handles open across calls takes a reference
+ * with sd_service_acquire() first. It watches for SD_STATE_REMOVED (state or
+ * callback), closes its handles and releases the reference; the volume is
+ * never unmounted under an open file.
+ *
+ * Mount state is published as the SD_SERVICE_READY_BIT of an event group
+ * (wait on it with sd_service_wait_ready()) and through an optional
+ * callback on every change.
+ */
+
+#define SD_SERVICE_RETRY_MIN_MS   500
+#define SD_SERVICE_RETRY_MAX_MS   30000
+#define SD_SERVICE_POLL_MS        1000
+#define SD_SERVICE_REMOVE_FAILS   3      // Consecutive CMD13 failures that mean removal
+#define SD_SERVICE_PRIORITY       2
+#define SD_SERVICE_STACK_SIZE     4096
+#define SD_SERVICE_READY_BIT      (1 << 0)
+
+typedef enum {
+    SD_STATE_NO_CARD = 0,   // Not mounted, retrying
+    SD_STATE_MOUNTED,
+    SD_STATE_REMOVED,       // Card stopped responding; unmounted once users release it
+} sd_state_t;
+
+typedef void (*sd_state_cb_t)(sd_state_t state, void* ctx);
+
+/**
+ * @brief Start the mount service task (returns immediately)
+ * @param config SD card configuration (copied)
+ * @return true if the task was started
+ */
+bool sd_service_start(const sd_config_t* config);
+
+/**
+ * @brief Register a callback for mount state changes (runs in the service task)
+ *
+ * SD_STATE_REMOVED is reported before the volume is unmounted.
+ */
+void sd_service_set_callback(sd_state_cb_t cb, void* ctx);
+
+/**
+ * @brief Wait until the card is mounted
+ * @param timeout Maximum time to wait (0 = just check)
+ * @return true if mounted
+ */
+bool sd_service_wait_ready(TickType_t timeout);
+
+/**
+ * @brief Current mount state
+ */
+sd_state_t sd_service_state(void);
+
+/**
+ * @brief Keep the volume mounted while files or raw handles are open
+ * @return true if the card is mounted; false (no reference taken) otherwise
+ */
+bool sd_service_acquire(void);
+
+/**
+ * @brief Drop a reference from sd_service_acquire() after closing every handle
+ */
+void sd_service_release(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SD_SERVICE_H
@@ -1,71 +1,384 @@
 #include "sd_spi.h"
+#include "sd_cache.h"
 #include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 #include "esp_log.h"
 #include "esp_vfs_fat.h"
 #include "driver/sdspi_host.h"
+#include "driver/sdmmc_host.h"
 #include "sdmmc_cmd.h"
+#include "diskio_sdmmc.h"
+#include "diskio_impl.h"
+#include "esp_heap_caps.h"
 
 static const char *TAG = "SD_SPI";
 static sdmmc_card_t *card = NULL;
 static bool sd_mounted = false;
 
 #define MOUNT_POINT "/sdcard"
+#define MAX_OPEN_FILES 5
 
-bool sd_init(int cs_pin, int mosi_pin, int miso_pin, int clk_pin) {
-    ESP_LOGI(TAG, "Initializing SD card on SPI3");
-    
-    // Clean up any previous attempt
-    if (sd_mounted) {
-        esp_vfs_fat_sdcard_unmount(MOUNT_POINT, card);
-        sd_mounted = false;
-        card = NULL;
-    }
-    
-    // Small delay to let card settle after power-on
-    vTaskDelay(pdMS_TO_TICKS(100));
+// LRU of open handles for sd_read_chunk/sd_load_image. Kept below
+// MAX_OPEN_FILES so frame streams and other fopen() users still get handles.
+#define FILE_CACHE_SIZE 3
+#define FILE_CACHE_NAME_LEN 48
+
+_Static_assert(FILE_CACHE_SIZE < MAX_OPEN_FILES, "File cache must leave VFS handles free");
 
-    // Initialize SPI3 bus for SD card (separate from display SPI2)
-    ESP_LOGI(TAG, "SPI3 Pins: MOSI=%d, MISO=%d, CLK=%d, CS=%d", mosi_pin, miso_pin, clk_pin, cs_pin);
+static const esp_vfs_fat_sdmmc_mount_config_t mount_config = {
+    .format_if_mount_failed = false,
+    .max_files = MAX_OPEN_FILES,
+    .allocation_unit_size = SD_ALLOCATION_UNIT_SIZE
+};
+
+typedef struct {
+    FILE* file;
+    char name[FILE_CACHE_NAME_LEN];
+    uint32_t last_used;
+} cached_file_t;
+
+static cached_file_t file_cache[FILE_CACHE_SIZE];
+static uint32_t file_cache_clock = 0;
+static SemaphoreHandle_t file_cache_lock = NULL;
+
+static sd_backend_t active_backend = SD_BACKEND_SPI;
+
+// Adaptive clock: candidate bus clocks, fastest first. The card is mounted
+// at the fastest step the config allows (falling back a step on mount
+// errors), then each step is verified against a reference read of a known
+// region taken at the safe clock.
+static const uint32_t clock_steps_khz[] = { 40000, 26000, 20000, 10000 };
+#define CLOCK_STEP_COUNT ((uint8_t)(sizeof(clock_steps_khz) / sizeof(clock_steps_khz[0])))
+#define CLOCK_SAFE_KHZ        10000
+#define CLOCK_VERIFY_SECTORS  32     // Known region: boot sector + reserved area (16 KB)
+#define CLOCK_VERIFY_PASSES   4
+#define CLOCK_DOWNGRADE_ERRORS 3     // CRC errors at one clock before stepping down
+
+static SemaphoreHandle_t card_lock = NULL;   // Serializes all card I/O (raw, FATFS, CMD13) and clock changes
+static uint8_t clock_step = 0;               // Index into clock_steps_khz
+static sd_clock_status_t clock_status;
+static uint32_t errors_at_clock = 0;
+
+// Mount over SDSPI on SPI3 (separate from display SPI2)
+static esp_err_t mount_spi(const sd_config_t* config, uint32_t freq_khz) {
+    ESP_LOGI(TAG, "SPI3 Pins: MOSI=%d, MISO=%d, CLK=%d, CS=%d",
+             config->pin_cmd, config->pin_d0, config->pin_clk, config->pin_d3);
     
     spi_bus_config_t bus_cfg = {
-        .mosi_io_num = mosi_pin,
-        .miso_io_num = miso_pin,
-        .sclk_io_num = clk_pin,
+        .mosi_io_num = config->pin_cmd,
+        .miso_io_num = config->pin_d0,
+        .sclk_io_num = config->pin_clk,
         .quadwp_io_num = -1,
         .quadhd_io_num = -1,
-        .max_transfer_sz = 65536,  // Increase max transfer size for faster reads
+        .max_transfer_sz = SD_MAX_TRANSFER_SZ,  // Increase max transfer size for faster reads
         .flags = SPICOMMON_BUSFLAG_MASTER,
     };
     
     esp_err_t ret = spi_bus_initialize(SPI3_HOST, &bus_cfg, SPI_DMA_CH_AUTO);
     if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) {
         ESP_LOGE(TAG, "Failed to initialize SPI3 bus: %s", esp_err_to_name(ret));
-        return false;
+        return ret;
     }
     ESP_LOGI(TAG, "SPI3 bus initialized successfully");
 
-    esp_vfs_fat_sdmmc_mount_config_t mount_config = {
-        .format_if_mount_failed = false,
-        .max_files = 5,
-        .allocation_unit_size = 16 * 1024
-    };
-
     sdmmc_host_t host = SDSPI_HOST_DEFAULT();
     host.slot = SPI3_HOST;  // Use SPI3 instead of default SPI2
-    host.max_freq_khz = 20000;  // 20MHz for fast reading
+    host.max_freq_khz = freq_khz;
     
     ESP_LOGI(TAG, "Host config: slot=%d, max_freq=%d kHz", host.slot, host.max_freq_khz);
 
     sdspi_device_config_t slot_config = SDSPI_DEVICE_CONFIG_DEFAULT();
-    slot_config.gpio_cs = cs_pin;
+    slot_config.gpio_cs = config->pin_d3;
     slot_config.host_id = SPI3_HOST;
     
     ESP_LOGI(TAG, "Slot config: CS=%d, host_id=%d", slot_config.gpio_cs, slot_config.host_id);
 
+    // Card init turns on SPI-mode CRC (CMD59), so marginal clocks show up as
+    // ESP_ERR_INVALID_CRC instead of bad data
     ESP_LOGI(TAG, "Attempting to mount SD card on SPI3...");
-    ret = esp_vfs_fat_sdspi_mount(MOUNT_POINT, &host, &slot_config, &mount_config, &card);
+    return esp_vfs_fat_sdspi_mount(MOUNT_POINT, &host, &slot_config, &mount_config, &card);
+}
+
+// Mount over the native SDMMC controller (pins routed through the GPIO matrix)
+static esp_err_t mount_sdmmc(const sd_config_t* config, uint32_t freq_khz) {
+    uint8_t width = (config->bus_width == 4) ? 4 : 1;
+    ESP_LOGI(TAG, "SDMMC %d-bit Pins: CLK=%d, CMD=%d, D0=%d, D1=%d, D2=%d, D3=%d", width,
+             config->pin_clk, config->pin_cmd, config->pin_d0, config->pin_d1, config->pin_d2, config->pin_d3);
+
+    sdmmc_host_t host = SDMMC_HOST_DEFAULT();
+    host.max_freq_khz = freq_khz;
+
+    ESP_LOGI(TAG, "Host config: slot=%d, max_freq=%d kHz", host.slot, host.max_freq_khz);
+
+    sdmmc_slot_config_t slot_config = SDMMC_SLOT_CONFIG_DEFAULT();
+    slot_config.width = width;
+    slot_config.clk = config->pin_clk;
+    slot_config.cmd = config->pin_cmd;
+    slot_config.d0 = config->pin_d0;
+    if (width == 4) {
+        slot_config.d1 = config->pin_d1;
+        slot_config.d2 = config->pin_d2;
+        slot_config.d3 = config->pin_d3;
+    }
+    // Boards without external 10k pull-ups on CMD/DAT still work at lower speeds
+    slot_config.flags |= SDMMC_SLOT_FLAG_INTERNAL_PULLUP;
+
+    ESP_LOGI(TAG, "Attempting to mount SD card on SDMMC...");
+    return esp_vfs_fat_sdmmc_mount(MOUNT_POINT, &host, &slot_config, &mount_config, &card);
+}
+
+static esp_err_t set_clock(uint8_t step) {
+    esp_err_t ret = card->host.set_card_clk(card->host.slot, clock_steps_khz[step]);
+    if (ret == ESP_OK) {
+        clock_step = step;
+        clock_status.freq_khz = clock_steps_khz[step];
+    }
+    return ret;
+}
+
+// Read the known region CLOCK_VERIFY_PASSES times at the current clock and
+// compare with the reference
+static bool verify_clock(uint8_t* buf, const uint8_t* ref) {
+    for (int pass = 0; pass < CLOCK_VERIFY_PASSES; pass++) {
+        esp_err_t ret = sdmmc_read_sectors(card, buf, 0, CLOCK_VERIFY_SECTORS);
+        if (ret == ESP_ERR_INVALID_CRC) {
+            clock_status.crc_errors++;
+        }
+        if (ret != ESP_OK || memcmp(buf, ref, CLOCK_VERIFY_SECTORS * 512) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Settle on the fastest step (at or below the mount clock) that reads the
+// known region back identically to the safe clock
+static void probe_clock(uint8_t mount_step) {
+    size_t bytes = CLOCK_VERIFY_SECTORS * 512;
+    uint8_t* ref = heap_caps_malloc(bytes, MALLOC_CAP_DMA);
+    uint8_t* buf = heap_caps_malloc(bytes, MALLOC_CAP_DMA);
+    uint8_t safe_step = CLOCK_STEP_COUNT - 1;
+
+    // Never go above what the driver negotiated (card speed class / HS mode)
+    while (mount_step < safe_step && clock_steps_khz[mount_step] > (uint32_t)card->real_freq_khz) {
+        mount_step++;
+    }
+    clock_step = mount_step;
+    clock_status.freq_khz = clock_steps_khz[mount_step];
+
+    if (ref == NULL || buf == NULL) {
+        ESP_LOGW(TAG, "No memory to probe the clock - staying at %lu kHz",
+                 (unsigned long)clock_status.freq_khz);
+        goto done;
+    }
+
+    // Reference read at the safe clock, twice to make sure it is stable
+    if (set_clock(safe_step) != ESP_OK ||
+        sdmmc_read_sectors(card, ref, 0, CLOCK_VERIFY_SECTORS) != ESP_OK ||
+        !verify_clock(buf, ref)) {
+        ESP_LOGW(TAG, "Reference read failed - staying at %d kHz", CLOCK_SAFE_KHZ);
+        set_clock(safe_step);
+        goto done;
+    }
+
+    for (uint8_t step = mount_step; step < safe_step; step++) {
+        if (set_clock(step) == ESP_OK && verify_clock(buf, ref)) {
+            goto done;
+        }
+        ESP_LOGW(TAG, "Clock %lu kHz failed verification", (unsigned long)clock_steps_khz[step]);
+    }
+    set_clock(safe_step);
+
+done:
+    heap_caps_free(ref);
+    heap_caps_free(buf);
+    errors_at_clock = 0;
+    ESP_LOGI(TAG, "SD clock: %lu kHz (%lu CRC errors while probing)",
+             (unsigned long)clock_status.freq_khz, (unsigned long)clock_status.crc_errors);
+}
+
+bool sd_fatfs_path(const char* path, char* out, size_t size) {
+    if (!sd_mounted || path == NULL || out == NULL) {
+        return false;
+    }
+
+    // FATFS addresses the volume by drive number rather than VFS mount point
+    BYTE pdrv = ff_diskio_get_pdrv_card(card);
+    if (pdrv == 0xFF) {
+        return false;
+    }
+    size_t prefix = strlen(MOUNT_POINT);
+    if (strncmp(path, MOUNT_POINT, prefix) == 0 && path[prefix] == '/') {
+        path += prefix + 1;
+    }
+    int len = snprintf(out, size, "%d:/%s", pdrv, path);
+    return len > 0 && (size_t)len < size;
+}
+
+// FATFS disk I/O for the mounted card: the same transfers as the driver's
+// own diskio, but under card_lock (reads also get the CRC retry), so stdio,
+// the logger and the handle cache never run into a clock change
+static DSTATUS locked_disk_init(unsigned char pdrv) {
+    (void)pdrv;
+    return 0;
+}
+
+static DSTATUS locked_disk_status(unsigned char pdrv) {
+    (void)pdrv;
+    return 0;
+}
+
+static DRESULT locked_disk_read(unsigned char pdrv, unsigned char* buff, uint32_t sector, unsigned count) {
+    (void)pdrv;
+    esp_err_t ret = sd_read_sectors(buff, sector, count);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "FATFS read of %u sectors at %lu failed: %s", count, (unsigned long)sector, esp_err_to_name(ret));
+        return RES_ERROR;
+    }
+    return RES_OK;
+}
+
+static DRESULT locked_disk_write(unsigned char pdrv, const unsigned char* buff, uint32_t sector, unsigned count) {
+    (void)pdrv;
+    xSemaphoreTake(card_lock, portMAX_DELAY);
+    esp_err_t ret = sd_mounted ? sdmmc_write_sectors(card, buff, sector, count) : ESP_ERR_INVALID_STATE;
+    xSemaphoreGive(card_lock);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "FATFS write of %u sectors at %lu failed: %s", count, (unsigned long)sector, esp_err_to_name(ret));
+        return RES_ERROR;
+    }
+    return RES_OK;
+}
+
+static DRESULT locked_disk_ioctl(unsigned char pdrv, unsigned char cmd, void* buff) {
+    (void)pdrv;
+    switch (cmd) {
+        case CTRL_SYNC:
+            return RES_OK;  // Writes complete before write() returns
+        case GET_SECTOR_COUNT:
+            *((DWORD*)buff) = (DWORD)card->csd.capacity;
+            return RES_OK;
+        case GET_SECTOR_SIZE:
+            *((WORD*)buff) = (WORD)card->csd.sector_size;
+            return RES_OK;
+        default:
+            return RES_ERROR;
+    }
+}
+
+static const ff_diskio_impl_t locked_diskio = {
+    .init = locked_disk_init,
+    .status = locked_disk_status,
+    .read = locked_disk_read,
+    .write = locked_disk_write,
+    .ioctl = locked_disk_ioctl,
+};
+
+esp_err_t sd_read_sectors(void* dst, uint32_t sector, uint32_t count) {
+    if (card_lock == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    xSemaphoreTake(card_lock, portMAX_DELAY);
+    esp_err_t ret = ESP_ERR_INVALID_STATE;
+    for (int attempt = 0; attempt < 2 && sd_mounted; attempt++) {
+        ret = sdmmc_read_sectors(card, dst, sector, count);
+        if (ret != ESP_ERR_INVALID_CRC) {
+            break;
+        }
+
+        // CRC error: step the clock down once they repeat, then retry
+        clock_status.crc_errors++;
+        if (++errors_at_clock >= CLOCK_DOWNGRADE_ERRORS && clock_step + 1 < CLOCK_STEP_COUNT) {
+            if (set_clock(clock_step + 1) == ESP_OK) {
+                clock_status.downgrades++;
+                errors_at_clock = 0;
+                ESP_LOGW(TAG, "Repeated CRC errors - SD clock lowered to %lu kHz",
+                         (unsigned long)clock_status.freq_khz);
+            }
+        }
+    }
+    if (ret != ESP_OK) {
+        clock_status.read_errors++;
+    }
+    xSemaphoreGive(card_lock);
+    return ret;
+}
+
+esp_err_t sd_card_status(void) {
+    if (card_lock == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    xSemaphoreTake(card_lock, portMAX_DELAY);
+    esp_err_t ret = sd_mounted ? sdmmc_get_status(card) : ESP_ERR_INVALID_STATE;
+    xSemaphoreGive(card_lock);
+    return ret;
+}
+
+void sd_get_clock_status(sd_clock_status_t* status) {
+    if (status != NULL) {
+        *status = clock_status;
+    }
+}
+
+void sd_log_clock_status(void) {
+    ESP_LOGI(TAG, "SD clock %lu kHz: %lu CRC errors, %lu read errors, %lu downgrades",
+             (unsigned long)clock_status.freq_khz, (unsigned long)clock_status.crc_errors,
+             (unsigned long)clock_status.read_errors, (unsigned long)clock_status.downgrades);
+}
+
+bool sd_init(int cs_pin, int mosi_pin, int miso_pin, int clk_pin) {
+    sd_config_t config = {
+        .backend = SD_BACKEND_SPI,
+        .pin_clk = clk_pin,
+        .pin_cmd = mosi_pin,
+        .pin_d0 = miso_pin,
+        .pin_d3 = cs_pin,
+        .pin_d1 = -1,
+        .pin_d2 = -1,
+        .bus_width = 1,
+        .max_freq_khz = 20000
+    };
+    return sd_init_config(&config);
+}
+
+bool sd_init_config(const sd_config_t* config) {
+    if (config == NULL) {
+        return false;
+    }
+
+    ESP_LOGI(TAG, "Initializing SD card on %s", config->backend == SD_BACKEND_SDMMC ? "SDMMC" : "SPI3");
     
-    ESP_LOGI(TAG, "Mount attempt result: %s (0x%x)", esp_err_to_name(ret), ret);
+    // Clean up any previous attempt
+    if (sd_mounted) {
+        sd_unmount();
+    }
+    
+    // No settle delay: the card has been powered since reset, and card init
+    // polls ACMD41 until the card reports ready
+
+    // Mount at the fastest allowed step; bad responses or a failed FAT mount
+    // at that clock fall back to the next step (no card fails the same way
+    // at every clock, so other errors stop here)
+    uint32_t max_khz = config->max_freq_khz ? config->max_freq_khz : clock_steps_khz[0];
+    uint8_t step = 0;
+    while (step + 1 < CLOCK_STEP_COUNT && clock_steps_khz[step] > max_khz) {
+        step++;
+    }
+    esp_err_t ret;
+    while (true) {
+        ret = (config->backend == SD_BACKEND_SDMMC) ? mount_sdmmc(config, clock_steps_khz[step])
+                                                    : mount_spi(config, clock_steps_khz[step]);
+        ESP_LOGI(TAG, "Mount attempt at %lu kHz: %s (0x%x)",
+                 (unsigned long)clock_steps_khz[step], esp_err_to_name(ret), ret);
+        bool clock_related = (ret == ESP_ERR_INVALID_CRC || ret == ESP_ERR_INVALID_RESPONSE || ret == ESP_FAIL);
+        if (ret == ESP_OK || !clock_related || step + 1 >= CLOCK_STEP_COUNT) {
+            break;
+        }
+        step++;
+    }
 
     if (ret != ESP_OK) {
         if (ret == ESP_FAIL) {
@@ -76,6 +389,20 @@ bool sd_init(int cs_pin, int mosi_pin, int miso_pin, int clk_pin) {
         return false;
     }
 
+    if (file_cache_lock == NULL) {
+        file_cache_lock = xSemaphoreCreateMutex();
+    }
+    if (card_lock == NULL) {
+        card_lock = xSemaphoreCreateMutex();
+    }
+
+    memset(&clock_status, 0, sizeof(clock_status));
+    probe_clock(step);
+
+    // From here on FATFS transfers take card_lock like every other card access
+    ff_diskio_register(ff_diskio_get_pdrv_card(card), &locked_diskio);
+
+    active_backend = config->backend;
     sd_mounted = true;
 
     // Card info
@@ -89,11 +416,38 @@ bool sd_mount(void) {
     return sd_mounted;
 }
 
+sdmmc_card_t* sd_get_card(void) {
+    return sd_mounted ? card : NULL;
+}
+
+// Close every cached handle (caller holds file_cache_lock)
+static void file_cache_clear(void) {
+    for (int i = 0; i < FILE_CACHE_SIZE; i++) {
+        if (file_cache[i].file != NULL) {
+            fclose(file_cache[i].file);
+            file_cache[i].file = NULL;
+            file_cache[i].name[0] = '\0';
+        }
+    }
+}
+
 void sd_unmount(void) {
     if (sd_mounted) {
-        esp_vfs_fat_sdcard_unmount(MOUNT_POINT, card);
-        spi_bus_free(SPI3_HOST);
+        xSemaphoreTake(file_cache_lock, portMAX_DELAY);
+        file_cache_clear();
+        xSemaphoreGive(file_cache_lock);
+
+        // Stop raw readers (sd_get_card() returns NULL) and drop cached blocks
         sd_mounted = false;
+        sd_cache_invalidate();
+        xSemaphoreTake(card_lock, portMAX_DELAY);  // Wait out any raw read in flight
+        xSemaphoreGive(card_lock);
+
+        esp_vfs_fat_sdcard_unmount(MOUNT_POINT, card);
+        if (active_backend == SD_BACKEND_SPI) {
+            spi_bus_free(SPI3_HOST);
+        }
+        card = NULL;
         ESP_LOGI(TAG, "SD card unmounted");
     }
 }
@@ -108,10 +462,38 @@ static inline uint16_t invert_color(uint16_t color) {
     return ~color;
 }
 
-bool sd_load_image(const char* filename, uint16_t* buffer, uint32_t max_size) {
-    if (!sd_mounted) {
-        ESP_LOGE(TAG, "SD card not mounted");
-        return false;
+// Return an open handle for filename, reusing a cached one when possible.
+// Caller holds file_cache_lock. *cached is false for names too long to
+// cache; those handles must be closed by the caller.
+static FILE* file_cache_get(const char* filename, bool* cached) {
+    size_t len = strlen(filename);
+    *cached = len < FILE_CACHE_NAME_LEN;
+    file_cache_clock++;
+
+    cached_file_t* slot = NULL;
+    if (*cached) {
+        for (int i = 0; i < FILE_CACHE_SIZE; i++) {
+            if (file_cache[i].file != NULL && strcmp(file_cache[i].name, filename) == 0) {
+                file_cache[i].last_used = file_cache_clock;
+                return file_cache[i].file;
+            }
+        }
+
+        // Miss: take a free slot, else evict the least recently used one
+        slot = &file_cache[0];
+        for (int i = 0; i < FILE_CACHE_SIZE; i++) {
+            if (file_cache[i].file == NULL) {
+                slot = &file_cache[i];
+                break;
+            }
+            if (file_cache[i].last_used < slot->last_used) {
+                slot = &file_cache[i];
+            }
+        }
+        if (slot->file != NULL) {
+            fclose(slot->file);
+            slot->file = NULL;
+        }
     }
 
     char filepath[64];
@@ -120,44 +502,54 @@ bool sd_load_image(const char* filename, uint16_t* buffer, uint32_t max_size) {
     FILE* f = fopen(filepath, "rb");
     if (f == NULL) {
         ESP_LOGE(TAG, "Failed to open file: %s", filepath);
-        return false;
+        return NULL;
     }
 
-    // Read file
-    size_t bytes_read = fread(buffer, 1, max_size, f);
-    fclose(f);
-
-    if (bytes_read == 0) {
-        ESP_LOGE(TAG, "Failed to read file: %s", filepath);
-        return false;
+    if (slot != NULL) {
+        slot->file = f;
+        memcpy(slot->name, filename, len + 1);
+        slot->last_used = file_cache_clock;
     }
-
-    ESP_LOGI(TAG, "Loaded %d bytes from %s", bytes_read, filename);
-    return true;
+    return f;
 }
 
-bool sd_read_chunk(const char* filename, uint32_t offset, uint8_t* buffer, uint32_t size) {
+// Read size bytes at offset through the handle cache
+static size_t cached_read(const char* filename, uint32_t offset, void* buffer, uint32_t size) {
     if (!sd_mounted) {
         ESP_LOGE(TAG, "SD card not mounted");
-        return false;
+        return 0;
     }
 
-    char filepath[64];
-    snprintf(filepath, sizeof(filepath), "%s/%s", MOUNT_POINT, filename);
+    xSemaphoreTake(file_cache_lock, portMAX_DELAY);
 
-    FILE* f = fopen(filepath, "rb");
-    if (f == NULL) {
-        ESP_LOGE(TAG, "Failed to open file: %s", filepath);
-        return false;
+    bool cached;
+    size_t bytes_read = 0;
+    FILE* f = file_cache_get(filename, &cached);
+    if (f != NULL) {
+        if (fseek(f, offset, SEEK_SET) == 0) {
+            bytes_read = fread(buffer, 1, size, f);
+        }
+        if (!cached) {
+            fclose(f);
+        }
     }
 
-    fseek(f, offset, SEEK_SET);
-    size_t bytes_read = fread(buffer, 1, size, f);
-    fclose(f);
+    xSemaphoreGive(file_cache_lock);
+    return bytes_read;
+}
 
-    if (bytes_read != size) {
+bool sd_load_image(const char* filename, uint16_t* buffer, uint32_t max_size) {
+    size_t bytes_read = cached_read(filename, 0, buffer, max_size);
+
+    if (bytes_read == 0) {
+        ESP_LOGE(TAG, "Failed to read file: %s", filename);
         return false;
     }
 
+    ESP_LOGI(TAG, "Loaded %d bytes from %s", bytes_read, filename);
     return true;
 }
+
+bool sd_read_chunk(const char* filename, uint32_t offset, uint8_t* buffer, uint32_t size) {
+    return cached_read(filename, offset, buffer, size) == size;
+}
@@ -3,16 +3,79 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include "sdmmc_cmd.h"
+
+// Mount tuning, overridable from build_flags (see the sd-bench environment)
+#ifndef SD_ALLOCATION_UNIT_SIZE
+#define SD_ALLOCATION_UNIT_SIZE (16 * 1024)   // FAT cluster size when formatting
+#endif
+#ifndef SD_MAX_TRANSFER_SZ
+#define SD_MAX_TRANSFER_SZ 65536              // SPI3 bus max transfer size
+#endif
+
+// SD card host backend
+typedef enum {
+    SD_BACKEND_SPI = 0,     // SDSPI on SPI3_HOST (any 4 GPIOs, up to 40 MHz)
+    SD_BACKEND_SDMMC,       // Native SDMMC controller, 1-bit or 4-bit (up to 40 MHz)
+} sd_backend_t;
+
+// SD card configuration
+typedef struct {
+    sd_backend_t backend;
+    int pin_clk;            // SPI SCK / SDMMC CLK
+    int pin_cmd;            // SPI MOSI / SDMMC CMD
+    int pin_d0;             // SPI MISO / SDMMC DAT0
+    int pin_d3;             // SPI CS   / SDMMC DAT3
+    int pin_d1;             // SDMMC DAT1 (4-bit only, -1 otherwise)
+    int pin_d2;             // SDMMC DAT2 (4-bit only, -1 otherwise)
+    uint8_t bus_width;      // SDMMC: 1 or 4 (ignored for SPI)
+    uint32_t max_freq_khz;  // Upper bound for the adaptive clock (0 = 40 MHz)
+} sd_config_t;
+
+// Adaptive clock report
+typedef struct {
+    uint32_t freq_khz;      // Clock the card currently runs at
+    uint32_t crc_errors;    // Data CRC errors (probe + runtime)
+    uint32_t read_errors;   // Raw reads that failed after retry
+    uint32_t downgrades;    // Runtime clock step-downs
+} sd_clock_status_t;
 
 // Initialize SD card on SPI bus
 bool sd_init(int cs_pin, int mosi_pin, int miso_pin, int clk_pin);
 
+// Initialize SD card with an explicit backend (same mount point and API as sd_init).
+// The clock is probed at mount: the fastest of 40/26/20/10 MHz (up to
+// max_freq_khz) that reads a known region back intact is kept.
+bool sd_init_config(const sd_config_t* config);
+
 // Mount SD card filesystem
 bool sd_mount(void);
 
 // Unmount SD card filesystem
 void sd_unmount(void);
 
+// Mounted card handle for raw sector access (sd_raw.h); NULL when not mounted
+sdmmc_card_t* sd_get_card(void);
+
+// Translate "/sdcard/x" or "x" into a FATFS path ("0:/x") for direct f_* calls
+bool sd_fatfs_path(const char* path, char* out, size_t size);
+
+// Read sectors from the mounted card. Serialized with all other card I/O
+// (FATFS included) and clock changes; CRC errors are retried once and
+// repeated ones step the clock down.
+esp_err_t sd_read_sectors(void* dst, uint32_t sector, uint32_t count);
+
+// Ask the mounted card for its status (CMD13), serialized with card I/O.
+// ESP_ERR_INVALID_STATE when not mounted.
+esp_err_t sd_card_status(void);
+
+// Current clock and error counts
+void sd_get_clock_status(sd_clock_status_t* status);
+
+// Log the clock report
+void sd_log_clock_status(void);
+
 // Load image from SD card (240x320 RGB565 format)
 // Returns true if successful
 bool sd_load_image(const char* filename, uint16_t* buffer, uint32_t max_size);
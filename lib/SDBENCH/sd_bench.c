@@ -0,0 +1,78 @@
+#include "sd_bench.h"
+#include <stdio.h>
+
+// Small deterministic PRNG so random passes hit the same offsets every run
+static uint32_t bench_rand(uint32_t *state) {
+    *state = *state * 1664525u + 1013904223u;
+    return *state >> 8;
+}
+
+static void print_result(const sd_bench_io_t *io, const sd_bench_params_t *params, const char *pattern,
+                         bool aligned, uint32_t chunk, uint32_t reads, uint64_t bytes, int64_t us) {
+    if (us <= 0) {
+        us = 1;
+    }
+    printf("SDBENCH,%s,%lu,%s,%s,%s,%lu,%llu,%lld,%lu,%lu\n",
+           params->card, (unsigned long)params->clock_khz, io->name, pattern,
+           aligned ? "aligned" : "unaligned", (unsigned long)chunk,
+           (unsigned long long)bytes, (long long)us,
+           (unsigned long)(bytes * 1000000 / 1024 / (uint64_t)us),  // KB/s
+           (unsigned long)((uint64_t)reads * 1000000 / (uint64_t)us));
+}
+
+void sd_bench_print_header(void) {
+    printf("SDBENCH,card,clock_khz,path,pattern,buffer,chunk,bytes,us,kbps,reads_per_s\n");
+}
+
+bool sd_bench_run(const sd_bench_io_t *io, const char *path, const sd_bench_params_t *params, uint8_t *buffer) {
+    uint32_t size = 0;
+    if (!io->open(io->ctx, path, &size)) {
+        fprintf(stderr, "SDBENCH: %s could not open %s\n", io->name, path);
+        return false;
+    }
+
+    bool ok = true;
+    for (int c = 0; c < params->chunk_count && ok; c++) {
+        uint32_t chunk = params->chunk_sizes[c];
+        if (chunk == 0 || chunk > size) {
+            continue;
+        }
+        uint32_t seq_bytes = params->seq_bytes < size ? params->seq_bytes : size;
+        uint32_t seq_reads = seq_bytes / chunk;
+        uint32_t slots = size / chunk;
+
+        for (int a = 0; a < 2 && ok; a++) {
+            bool aligned = (a == 0);
+            uint8_t *dst = aligned ? buffer : buffer + 1;
+
+            // Sequential: whole chunks from the start of the file
+            int64_t start = params->now_us();
+            for (uint32_t i = 0; i < seq_reads && ok; i++) {
+                ok = io->read(io->ctx, i * chunk, dst, chunk) == chunk;
+            }
+            int64_t elapsed = params->now_us() - start;
+            if (ok && seq_reads > 0) {
+                print_result(io, params, "seq", aligned, chunk, seq_reads, (uint64_t)seq_reads * chunk, elapsed);
+            }
+
+            // Random: chunk-aligned offsets anywhere in the file
+            uint32_t seed = 12345 + chunk;
+            start = params->now_us();
+            for (uint32_t i = 0; i < params->random_reads && ok; i++) {
+                uint32_t offset = (bench_rand(&seed) % slots) * chunk;
+                ok = io->read(io->ctx, offset, dst, chunk) == chunk;
+            }
+            elapsed = params->now_us() - start;
+            if (ok && params->random_reads > 0) {
+                print_result(io, params, "random", aligned, chunk, params->random_reads,
+                             (uint64_t)params->random_reads * chunk, elapsed);
+            }
+        }
+    }
+
+    if (!ok) {
+        fprintf(stderr, "SDBENCH: %s read failed\n", io->name);
+    }
+    io->close(io->ctx);
+    return ok;
+}
@@ -0,0 +1,82 @@
+#ifndef SD_BENCH_H
+#define SD_BENCH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * SD read throughput benchmark
+ *
+ * Runs sequential and random reads over one test file for every chunk size,
+ * with a DMA-aligned and a deliberately misaligned (+1 byte) destination,
+ * through a read path given as an sd_bench_io_t (stdio, raw sectors, or the
+ * host mock in tools/bench/sd_bench_host.c). The code here is portable C so
+ * the firmware and the host runner share it.
+ *
+ * Each measurement is printed as one CSV line starting with "SDBENCH," so
+ * results can be grepped out of a serial log:
+ *   SDBENCH,card,clock_khz,path,pattern,buffer,chunk,bytes,us,kbps,reads_per_s
+ */
+
+#define SD_BENCH_MAX_CHUNKS   8
+#define SD_BENCH_ALIGN_SLACK  4      // Extra buffer bytes needed for the misaligned runs
+
+// Read path under test
+typedef struct {
+    const char *name;                                            // e.g. "stdio", "raw"
+    bool (*open)(void *ctx, const char *path, uint32_t *size);
+    uint32_t (*read)(void *ctx, uint32_t offset, void *buffer, uint32_t size);
+    void (*close)(void *ctx);
+    void *ctx;
+} sd_bench_io_t;
+
+typedef struct {
+    const char *card;               // Label printed with each result (card name, "mock", ...)
+    uint32_t clock_khz;             // Bus clock the card was mounted with
+    uint32_t chunk_sizes[SD_BENCH_MAX_CHUNKS];
+    uint8_t chunk_count;
+    uint32_t seq_bytes;             // Bytes per sequential pass (clipped to the file size)
+    uint32_t random_reads;          // Reads per random pass
+    int64_t (*now_us)(void);        // Monotonic clock
+} sd_bench_params_t;
+
+/**
+ * @brief Print the CSV column header line
+ */
+void sd_bench_print_header(void);
+
+/**
+ * @brief Run the sequential/random x aligned/misaligned matrix for one read path
+ * @param io Read path under test
+ * @param path Test file
+ * @param params Benchmark parameters
+ * @param buffer 4-byte aligned scratch, largest chunk + SD_BENCH_ALIGN_SLACK bytes
+ *               (DMA-capable on the target)
+ * @return true if every read succeeded
+ */
+bool sd_bench_run(const sd_bench_io_t *io, const char *path, const sd_bench_params_t *params, uint8_t *buffer);
+
+#ifdef ESP_PLATFORM
+#include "sd_spi.h"
+
+/**
+ * @brief Run the benchmark suite on the target and print the results
+ *
+ * Remounts the card at each clock in SD_BENCH_CLOCKS_KHZ, creates the test
+ * file if needed and measures the stdio, raw-sector and cached raw paths
+ * (firmware only, see the sd-bench environment in platformio.ini).
+ *
+ * @param base Card configuration; max_freq_khz is replaced per pass
+ */
+void sd_bench_app(const sd_config_t *base);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SD_BENCH_H
@@ -0,0 +1,174 @@
+#include "sd_bench.h"
+#include "sd_spi.h"
+#include "sd_raw.h"
+#include "sd_cache.h"
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+
+static const char *TAG = "SD_BENCH";
+
+#define BENCH_FILE        "/sdcard/sdbench.bin"
+#define BENCH_FILE_SIZE   (4 * 1024 * 1024)
+#define BENCH_WRITE_CHUNK (32 * 1024)
+
+// Clocks to sweep; mounts that fail at a clock are reported and skipped
+#ifndef SD_BENCH_CLOCKS_KHZ
+#define SD_BENCH_CLOCKS_KHZ { 10000, 20000, 26000, 40000 }
+#endif
+
+static const uint32_t bench_clocks[] = SD_BENCH_CLOCKS_KHZ;
+
+// stdio path: fopen/fseek/fread through VFS and FATFS
+static bool stdio_open(void *ctx, const char *path, uint32_t *size) {
+    FILE **f = ctx;
+    *f = fopen(path, "rb");
+    if (*f == NULL) {
+        return false;
+    }
+    fseek(*f, 0, SEEK_END);
+    *size = (uint32_t)ftell(*f);
+    return true;
+}
+
+static uint32_t stdio_read(void *ctx, uint32_t offset, void *buffer, uint32_t size) {
+    FILE **f = ctx;
+    if (fseek(*f, offset, SEEK_SET) != 0) {
+        return 0;
+    }
+    return (uint32_t)fread(buffer, 1, size, *f);
+}
+
+static void stdio_close(void *ctx) {
+    FILE **f = ctx;
+    fclose(*f);
+    *f = NULL;
+}
+
+// Raw-sector path (sd_raw.h), through the block cache once it is enabled
+static bool raw_open(void *ctx, const char *path, uint32_t *size) {
+    sd_raw_file_t *file = ctx;
+    if (!sd_raw_open(file, path)) {
+        return false;
+    }
+    *size = file->size;
+    return true;
+}
+
+static uint32_t raw_read(void *ctx, uint32_t offset, void *buffer, uint32_t size) {
+    return sd_raw_read(ctx, offset, buffer, size);
+}
+
+static void raw_close(void *ctx) {
+    sd_raw_close(ctx);
+}
+
+// Create the test file once (kept on the card between runs)
+static bool prepare_file(void) {
+    struct stat st;
+    if (stat(BENCH_FILE, &st) == 0 && st.st_size == BENCH_FILE_SIZE) {
+        return true;
+    }
+
+    ESP_LOGI(TAG, "Writing %d KB test file %s", BENCH_FILE_SIZE / 1024, BENCH_FILE);
+    uint8_t *block = heap_caps_malloc(BENCH_WRITE_CHUNK, MALLOC_CAP_DMA);
+    FILE *f = fopen(BENCH_FILE, "wb");
+    bool ok = (block != NULL && f != NULL);
+    for (uint32_t pos = 0; ok && pos < BENCH_FILE_SIZE; pos += BENCH_WRITE_CHUNK) {
+        for (int i = 0; i < BENCH_WRITE_CHUNK; i++) {
+            block[i] = (uint8_t)((pos + i) * 31 >> 3);
+        }
+        ok = fwrite(block, 1, BENCH_WRITE_CHUNK, f) == BENCH_WRITE_CHUNK;
+    }
+    if (f != NULL) {
+        fclose(f);
+    }
+    heap_caps_free(block);
+    if (!ok) {
+        ESP_LOGE(TAG, "Failed to write test file");
+    }
+    return ok;
+}
+
+// Remount at every clock and run the given read paths
+static void run_suite(const sd_config_t *base, sd_bench_io_t *paths, int path_count, uint8_t *buffer,
+                      sd_bench_params_t *params) {
+    for (int c = 0; c < (int)(sizeof(bench_clocks) / sizeof(bench_clocks[0])); c++) {
+        sd_config_t config = *base;
+        config.max_freq_khz = bench_clocks[c];
+        if (!sd_init_config(&config)) {
+            printf("SDBENCH_SKIP,%lu,mount failed\n", (unsigned long)bench_clocks[c]);
+            continue;
+        }
+        if (!prepare_file()) {
+            sd_unmount();
+            return;
+        }
+
+        sdmmc_card_t *card = sd_get_card();
+        char card_name[sizeof(card->cid.name) + 1] = {0};
+        memcpy(card_name, card->cid.name, sizeof(card->cid.name));
+        params->card = card_name;
+        params->clock_khz = card->real_freq_khz;
+
+        for (int p = 0; p < path_count; p++) {
+            sd_bench_run(&paths[p], BENCH_FILE, params, buffer);
+        }
+        sd_unmount();
+    }
+}
+
+void sd_bench_app(const sd_config_t *base) {
+    sd_bench_params_t params = {
+        .chunk_sizes = { 512, 4096, 16384, 25600, 32768, 65536 },  // 25,600 = one 40-line chunk
+        .chunk_count = 6,
+        .seq_bytes = 1024 * 1024,
+        .random_reads = 64,
+        .now_us = esp_timer_get_time
+    };
+
+    uint32_t max_chunk = 0;
+    for (int i = 0; i < params.chunk_count; i++) {
+        if (params.chunk_sizes[i] > max_chunk) max_chunk = params.chunk_sizes[i];
+    }
+    uint8_t *buffer = heap_caps_aligned_alloc(4, max_chunk + SD_BENCH_ALIGN_SLACK, MALLOC_CAP_DMA);
+    if (buffer == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate %lu byte buffer", (unsigned long)max_chunk);
+        return;
+    }
+
+    static FILE *stdio_file;
+    static sd_raw_file_t raw_file;
+    sd_bench_io_t direct[] = {
+        { "stdio", stdio_open, stdio_read, stdio_close, &stdio_file },
+        { "raw", raw_open, raw_read, raw_close, &raw_file },
+    };
+    sd_bench_io_t cached[] = {
+        { "raw_cache", raw_open, raw_read, raw_close, &raw_file },
+    };
+
+    ESP_LOGI(TAG, "SD throughput benchmark: AU=%d, max_transfer_sz=%d",
+             SD_ALLOCATION_UNIT_SIZE, SD_MAX_TRANSFER_SZ);
+    sd_bench_print_header();
+    run_suite(base, direct, 2, buffer, &params);
+
+    // The block cache cannot be turned off again, so cached runs come last
+    sd_cache_config_t cache_config = {
+        .block_count = 4,
+        .prefetch_blocks = 2,
+        .task_core = 0,
+        .task_priority = 5
+    };
+    if (sd_cache_init(&cache_config)) {
+        run_suite(base, cached, 1, buffer, &params);
+        sd_cache_log_stats();
+    }
+
+    heap_caps_free(buffer);
+    printf("SDBENCH_DONE\n");
+}
@@ -0,0 +1,127 @@
+#!/usr/bin/env python3
+"""Pack images into an indexed asset blob for the "assets" flash partition
+
+Mirrors lib/ASSETS/asset_pack.h. Each asset is NAME=PATH; its ID is its
+position on the command line. Without arguments the boot splash and any
+data/nyan_N.raw / data/nyan_N.jpg frames are packed.
+
+Flash the result without rebuilding the firmware:
+  parttool.py --port COMx write_partition --partition-name assets --input assets.bin
+or, at the partition offset from partitions.csv:
+  esptool.py --chip esp32s3 --port COMx write_flash 0x110000 assets.bin
+"""
+
+import argparse
+import glob
+import re
+import struct
+import zlib
+
+PACK_MAGIC = b'NYAP'
+PACK_VERSION = 1
+PACK_ALIGN = 64            # ASSET_PACK_ALIGN
+NAME_MAX = 24              # ASSET_NAME_MAX, including the NUL
+HEADER_SIZE = 32
+ENTRY_SIZE = 40
+PARTITION_SIZE = 0xF0000   # "assets" size in partitions.csv
+
+TYPE_BLOB, TYPE_FRAME, TYPE_JPEG, TYPE_RAW = 0, 1, 2, 3
+TYPE_NAMES = {TYPE_BLOB: 'blob', TYPE_FRAME: 'nyf1', TYPE_JPEG: 'jpeg', TYPE_RAW: 'raw'}
+
+def name_hash(name):
+    """FNV-1a, same as asset_name_hash()"""
+    h = 2166136261
+    for b in name.encode('ascii'):
+        h = ((h ^ b) * 16777619) & 0xFFFFFFFF
+    return h
+
+def detect_type(data, path):
+    if data[:4] == b'NYF1':
+        return TYPE_FRAME
+    if data[:2] == b'\xff\xd8':
+        return TYPE_JPEG
+    if path.endswith('.raw'):
+        return TYPE_RAW
+    return TYPE_BLOB
+
+def align(n):
+    return (n + PACK_ALIGN - 1) & ~(PACK_ALIGN - 1)
+
+def build_pack(assets):
+    """assets: list of (name, data, type) in ID order; returns the pack bytes"""
+    names = [name for name, _, _ in assets]
+    if len(set(names)) != len(names):
+        raise ValueError("Asset names must be unique")
+    for name in names:
+        if not name or len(name.encode('ascii')) >= NAME_MAX:
+            raise ValueError(f"Asset name '{name}' must be 1..{NAME_MAX - 1} characters")
+
+    # Hash table at most half full (short probes), power of two for masking
+    slot_count = 2
+    while slot_count < 2 * len(assets):
+        slot_count *= 2
+    slots = [0] * slot_count
+    for asset_id, name in enumerate(names):
+        i = name_hash(name) & (slot_count - 1)
+        while slots[i]:
+            i = (i + 1) & (slot_count - 1)
+        slots[i] = asset_id + 1
+
+    table_size = len(assets) * ENTRY_SIZE + slot_count * 2
+    offset = align(HEADER_SIZE + table_size)
+    entries = bytearray()
+    body = bytearray()
+    for name, data, asset_type in assets:
+        entries += struct.pack('<IIIHH', name_hash(name), offset, len(data), asset_type, 0)
+        entries += name.encode('ascii').ljust(NAME_MAX, b'\0')
+        body += data
+        body += b'\0' * (align(len(data)) - len(data))
+        offset += align(len(data))
+
+    tables = bytes(entries) + struct.pack(f'<{slot_count}H', *slots)
+    data_start = align(HEADER_SIZE + table_size)
+    total = data_start + len(body)
+    header = struct.pack('<4sHHHHII12x', PACK_MAGIC, PACK_VERSION, len(assets), slot_count, 0,
+                         total, zlib.crc32(tables))
+    pad = b'\0' * (data_start - HEADER_SIZE - len(tables))
+    return header + tables + pad + bytes(body)
+
+def default_assets():
+    """Boot splash plus any SD-card frames found in data/"""
+    assets = [('boot_splash', 'src/boot_splash.bin')]
+    def frame_number(path):
+        return int(re.search(r'nyan_(\d+)', path).group(1))
+    for ext in ('raw', 'jpg'):
+        for path in sorted(glob.glob(f'data/nyan_*.{ext}'), key=frame_number):
+            assets.append((f'nyan_{frame_number(path)}.{ext}', path))
+    return assets
+
+def main():
+    parser = argparse.ArgumentParser(description="Pack assets for the \"assets\" flash partition")
+    parser.add_argument('assets', nargs='*', metavar='NAME=PATH',
+                        help="Assets in ID order (default: boot splash + data/nyan_N frames)")
+    parser.add_argument('-o', '--output', default='assets.bin', help="Output file (default: assets.bin)")
+    args = parser.parse_args()
+
+    specs = [tuple(a.split('=', 1)) for a in args.assets] if args.assets else default_assets()
+    assets = []
+    for spec in specs:
+        if len(spec) != 2:
+            parser.error(f"'{spec[0]}' is not NAME=PATH")
+        name, path = spec
+        with open(path, 'rb') as f:
+            data = f.read()
+        assets.append((name, data, detect_type(data, path)))
+
+    pack = build_pack(assets)
+    if len(pack) > PARTITION_SIZE:
+        raise SystemExit(f"Pack is {len(pack)} bytes; the assets partition holds {PARTITION_SIZE}")
+    with open(args.output, 'wb') as f:
+        f.write(pack)
+
+    for asset_id, (name, data, asset_type) in enumerate(assets):
+        print(f"  {asset_id:3d}  {name:<24} {len(data):8d} bytes  {TYPE_NAMES[asset_type]}")
+    print(f"Packed {len(assets)} assets into {args.output} ({len(pack)} / {PARTITION_SIZE} bytes)")
+
+if __name__ == "__main__":
+    main()
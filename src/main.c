@@ -1,15 +1,34 @@
 #include <stdio.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
 #include "esp_log.h"
 #include "esp_timer.h"
 #include "driver/spi_master.h"
-#include "driver/i2c.h"
+#include "driver/i2c_types.h"
 #include "ili9341.h"
 #include "ft6236.h"
+#include "touch_service.h"
 #include "sd_spi.h"
+#include "sd_cache.h"
+#include "sd_service.h"
+#include "sd_logger.h"
+#include "dma_buf.h"
+#ifdef SD_BENCH
+#include "sd_bench.h"
+#endif
+#include "frame_cache.h"
+#include "frame_pipeline.h"
+#include "frame_jpeg.h"
+#include "frame_stream.h"
+#include "asset_pack.h"
+#include "frame_sched.h"
+#include "nyan_compositor.h"
 #include "lvgl.h"
 #include "lvgl_port.h"
+#include "boot_graph.h"
+#include "touch_latency.h"
+#include "app_sched.h"
 
 static const char *TAG = "CABLE_CONFIG";
 
@@ -44,8 +63,8 @@ static lv_obj_t *label_selected;
 static lv_style_t style_sel;
 
 // Color profile cycling
+#define PROFILE_CYCLE_MS 5000
 static int ui_color_profile = 0;
-static int64_t last_profile_change = 0;
 
 // UI State
 static uint8_t detected_cable_id = 0x00;  // Will be read from IC
@@ -53,18 +72,38 @@ static uint8_t detected_cable_id = 0x00;  // Will be read from IC
 // Screensaver
 #define SCREENSAVER_TIMEOUT_MS 10000
 static int64_t last_touch_time = 0;
-static bool screensaver_active = false;
+static volatile bool screensaver_active = false;  // Read by the display task on core 1
+static TaskHandle_t screensaver_task_handle = NULL;
+static SemaphoreHandle_t screensaver_done = NULL;  // Given when the display task has stopped drawing
+#define SCREENSAVER_CORE 1  // Display task core (SD reader runs on core 0)
+#define BOOT_SERIAL_DELAY_MS 0  // e.g. 3000 to catch boot logs on a late-attaching monitor
+
+// Main loop jobs (lib/SCHED)
+#define CABLE_POLL_MS 1000
+#define TELEMETRY_MS 5000
+#define TELEMETRY_STATS_EVERY 12  // Scheduler stats every 12 telemetry runs (1 minute)
+#define LVGL_MAX_SLEEP_MS 500     // Upper bound on the wait LVGL asks for
 
 // Nyan cat animation - Full screen 320x240
 #define NYAN_WIDTH 320
 #define NYAN_HEIGHT 240
+#define NYAN_FRAME_COUNT 12
 #define CHUNK_LINES 40  // Load 40 lines at a time (25,600 bytes per chunk)
-#define FRAME_DELAY_MS 0  // No delay - maximum speed
-static uint16_t* chunk_buffer = NULL;  // Small buffer for streaming
-static uint16_t* chunk_buffer2 = NULL;  // Secondary buffer for double buffering
+#define NYAN_DEFAULT_FRAME_MS 100  // Used when an asset carries no frame duration (legacy .raw)
+#define SCREENSAVER_USE_SD_FRAMES 0  // 1 = stream nyan_N.raw from SD, 0 = compose in RAM (no card needed)
+#define SD_RETRY_MS 5000  // Wait before restarting the SD reader after a failure
+#define SD_CACHE_BLOCKS 4     // 16 KB read-ahead blocks (internal DMA RAM) for SD frames
+#define SD_CACHE_PREFETCH 2   // Blocks read ahead once frames stream sequentially
+#define SD_CACHE_BYPASS (8 * 1024)  // Band reads this large DMA straight into the chunk buffer
+static dma_buf_t* chunk_bufs[2] = {NULL, NULL};  // Compositor band buffers (DMA-capable)
+static uint16_t* chunk_buffer = NULL;
+static uint16_t* chunk_buffer2 = NULL;
 static int current_frame = 0;
-static int64_t last_frame_time = 0;
-static FILE* current_file = NULL;  // Keep file open for faster access
+static frame_sched_t frame_sched;  // Paces whichever source is drawing
+static frame_cache_t frame_cache;  // Decoded SD frames in PSRAM (if fitted)
+static bool frame_cache_ready = false;
+static int64_t sd_retry_time = 0;
+static uint32_t compose_frame = 0;  // Free-running compositor frame counter
 
 // Update touch time (called from LVGL port layer)
 void update_touch_time(void) {
@@ -73,6 +112,8 @@ void update_touch_time(void) {
     // Exit screensaver on touch
     if (screensaver_active) {
         screensaver_active = false;
+        touch_service_set_idle(false);
+        xSemaphoreTake(screensaver_done, portMAX_DELAY);  // Display task has released SPI2
         ESP_LOGI(TAG, "*** SCREENSAVER EXITED - Returning to Rolodex ***");
         
         // Clear screen and restore LVGL UI
@@ -102,6 +143,8 @@ void update_touch_time(void) {
 #define TOUCH_SDA   8   // GPIO 8  → Pin 31 CTP_SDA (I2C Touch Data)
 #define TOUCH_SCL   9   // GPIO 9  → Pin 30 CTP_SCL (I2C Touch Clock)
 #define TOUCH_INT   3   // GPIO 3  → Pin 39 CTP_INT (Touch Interrupt, optional)
+#define TOUCH_I2C_FREQ  FT6236_I2C_FREQ_FAST  // FT6236_I2C_FREQ_FAST_PLUS with external pull-ups
+#define TOUCH_CORE      0   // Touch acquisition task core (LVGL runs there too)
 
 // SD Card - Separate SPI3 Bus
 #define SD_CS       16  // GPIO 16 - SD Card Chip Select
@@ -109,121 +152,212 @@ void update_touch_time(void) {
 #define SD_MISO     36  // GPIO 36 - SD Card MISO
 #define SD_SCK      18  // GPIO 18 - SD Card Clock
 
+// SD host backend: SPI3 (default) or native SDMMC. In 1-bit SDMMC mode the
+// existing wiring is reused (SCK=CLK, MOSI=CMD, MISO=DAT0, CS=DAT3); 4-bit
+// mode also needs DAT1/DAT2 wired to the card.
+#define SD_USE_SDMMC    0
+#define SD_BUS_WIDTH    1   // SDMMC: 1 or 4
+#define SD_D1           -1  // SDMMC DAT1 (4-bit only)
+#define SD_D2           -1  // SDMMC DAT2 (4-bit only)
+#define SD_FREQ_KHZ     40000  // Upper bound; the driver probes down to what the card passes
+
 // RGB LED - WS2812 on GPIO 48
 #define RGB_LED_PIN 48  // GPIO 48 - WS2812 RGB LED
 
-static void draw_nyan_screensaver(void) {
-    static bool bg_drawn = false;
-    static int last_loaded_frame = -1;
-    
-    // Draw dark background once
-    if (!bg_drawn) {
-        ili9341_fill_screen(0x0000);  // Black background
-        bg_drawn = true;
+// Wait for the drawn frame's slot to end, then advance (skipping frames when behind)
+static void next_sd_frame(uint16_t duration_ms) {
+    static uint32_t loops = 0;
+    
+    uint32_t advance = frame_sched_wait(&frame_sched, duration_ms ? duration_ms : NYAN_DEFAULT_FRAME_MS);
+    
+    int next = (current_frame + advance) % NYAN_FRAME_COUNT;
+    if (next < current_frame && ++loops % 10 == 0) {
+        frame_cache_log_stats(&frame_cache);
+        sd_cache_log_stats();
+        sd_log_clock_status();
+        dma_buf_log_stats();
+        ili9341_log_stage_stats();
     }
-    
-    // Allocate double buffers once (40 lines each = 25,600 bytes)
-    if (chunk_buffer == NULL) {
-        chunk_buffer = (uint16_t*)malloc(NYAN_WIDTH * CHUNK_LINES * 2);
-        chunk_buffer2 = (uint16_t*)malloc(NYAN_WIDTH * CHUNK_LINES * 2);
-        if (chunk_buffer == NULL || chunk_buffer2 == NULL) {
-            ESP_LOGE(TAG, "Failed to allocate buffers (%d bytes each)", NYAN_WIDTH * CHUNK_LINES * 2);
-            return;
-        }
-        ESP_LOGI(TAG, "Allocated double buffers: %d bytes each for %d lines", NYAN_WIDTH * CHUNK_LINES * 2, CHUNK_LINES);
+    current_frame = next;
+    frame_pipeline_request_frame(current_frame);
+}
+
+// Stop the SD reader, free the read-ahead blocks (internal RAM) and let the
+// card be unmounted. The cache goes while the volume is still held, so it
+// never races the service's unmount.
+static void stop_sd_frames(void) {
+    bool holding = frame_pipeline_running();
+    frame_pipeline_stop();
+    sd_cache_deinit();
+    if (holding) {
+        sd_service_release();
     }
-    
-    // Open new file if frame changed
-    if (current_frame != last_loaded_frame) {
-        if (current_file != NULL) {
-            fclose(current_file);
-            current_file = NULL;
+}
+
+// Stop the SD reader after a failure and leave the card alone for a while
+static void sd_frames_failed(void) {
+    stop_sd_frames();
+    sd_retry_time = esp_timer_get_time() / 1000 + SD_RETRY_MS;
+}
+
+// Show one pre-rendered frame read from SD by the reader task on core 0;
+// false if no card or frame is unavailable
+static bool draw_sd_frame(void) {
+    extern void ili9341_write_pixels(const uint16_t* pixels, uint32_t length);
+    
+    if (!frame_pipeline_running()) {
+        if (esp_timer_get_time() / 1000 < sd_retry_time) {
+            return false;
+        }
+        // Card not mounted (yet) - compose this frame, check again next frame.
+        // The reader holds the volume until it is stopped.
+        if (!sd_service_acquire()) {
+            return false;
+        }
+        if (!frame_cache_ready) {
+            frame_cache_init(&frame_cache, NYAN_FRAME_COUNT, NYAN_WIDTH, NYAN_HEIGHT);
+            frame_cache_ready = true;
         }
         
-        char filepath[64];
-        snprintf(filepath, sizeof(filepath), "/sdcard/nyan_%d.raw", current_frame);
-        current_file = fopen(filepath, "rb");
+        // Prefetch on core 0 above the reader task so read-ahead overlaps decoding
+        sd_cache_config_t sd_cache_config = {
+            .block_count = SD_CACHE_BLOCKS,
+            .prefetch_blocks = SD_CACHE_PREFETCH,
+            .task_core = FRAME_PIPELINE_CORE,
+            .task_priority = FRAME_PIPELINE_PRIORITY + 1,
+            .bypass_min = SD_CACHE_BYPASS
+        };
+        sd_cache_init(&sd_cache_config);
         
-        if (current_file == NULL) {
-            ESP_LOGE(TAG, "Failed to open file: %s", filepath);
-            return;
+        frame_pipeline_config_t pipe_config = {
+            .path_fmt = "/sdcard/nyan_%d.raw",
+            .jpeg_path_fmt = "/sdcard/nyan_%d.jpg",
+            .frame_count = NYAN_FRAME_COUNT,
+            .width = NYAN_WIDTH,
+            .height = NYAN_HEIGHT,
+            .band_lines = CHUNK_LINES,
+            .cache = &frame_cache
+        };
+        frame_pipeline_request_frame(current_frame);
+        if (!frame_pipeline_start(&pipe_config)) {
+            sd_frames_failed();
+            sd_service_release();
+            return false;
         }
-        last_loaded_frame = current_frame;
+    } else if (sd_service_state() != SD_STATE_MOUNTED) {
+        // Card removed: close the frame files so the service can unmount
+        sd_frames_failed();
+        return false;
     }
     
-    // Stream current frame from SD card with double buffering
-    if (sd_mount() && current_file != NULL) {
-        extern void ili9341_write_pixels(const uint16_t* pixels, uint32_t length);
-        
-        // Rewind file to start
-        fseek(current_file, 0, SEEK_SET);
-        
-        uint32_t chunk_size = NYAN_WIDTH * CHUNK_LINES * 2;
-        uint16_t* current_buffer = chunk_buffer;
-        uint16_t* next_buffer = chunk_buffer2;
-        
-        // Pre-read first chunk
-        size_t bytes_read = fread(current_buffer, 1, chunk_size, current_file);
+    // Send chunks to the panel while the reader fills the next ring slots
+    uint16_t duration_ms = 0;
+    for (int y = 0; y < NYAN_HEIGHT; ) {
+        frame_chunk_t chunk;
+        if (!frame_pipeline_peek(&chunk, pdMS_TO_TICKS(1000))) {
+            ESP_LOGE(TAG, "SD reader stalled at frame %d line %d", current_frame, y);
+            sd_frames_failed();
+            return false;
+        }
         
-        // Stream image in 40-line chunks (6 chunks for 240 lines) with double buffering
-        for (int y = 0; y < NYAN_HEIGHT; y += CHUNK_LINES) {
-            if (bytes_read != chunk_size) {
-                ESP_LOGE(TAG, "Failed to read chunk at line %d", y);
-                break;
+        if (chunk.flags & FRAME_CHUNK_ERROR) {
+            frame_pipeline_release();
+            if (chunk.frame == current_frame) {
+                sd_frames_failed();
+                return false;
             }
-            
-            // Start reading next chunk while writing current chunk
-            size_t next_bytes = 0;
-            if (y + CHUNK_LINES < NYAN_HEIGHT) {
-                next_bytes = fread(next_buffer, 1, chunk_size, current_file);
-            }
-            
-            // Write current chunk to display
-            ili9341_set_addr_window(0, y, NYAN_WIDTH - 1, y + CHUNK_LINES - 1);
-            ili9341_write_pixels(current_buffer, NYAN_WIDTH * CHUNK_LINES);
-            
-            // Swap buffers for next iteration
-            uint16_t* temp = current_buffer;
-            current_buffer = next_buffer;
-            next_buffer = temp;
-            bytes_read = next_bytes;
+            continue;
         }
         
-        // Advance to next frame after successful draw
-        current_frame = (current_frame + 1) % 12;  // 12 frames total
-    } else {
-        ESP_LOGE(TAG, "SD card not mounted!");
+        // Drop chunks read ahead for frames the scheduler skipped
+        if (chunk.frame != current_frame || chunk.y != y) {
+            frame_pipeline_release();
+            continue;
+        }
+        
+        ili9341_set_addr_window(0, y, NYAN_WIDTH - 1, y + chunk.lines - 1);
+        ili9341_write_pixels(chunk.pixels, NYAN_WIDTH * chunk.lines);
+        duration_ms = chunk.duration_ms;
+        y += chunk.lines;
+        frame_pipeline_release();
     }
     
-    // Check for touch to exit screensaver
-    ft6236_touch_t touch_data;
-    if (ft6236_read_touch(&touch_data)) {
-        ESP_LOGI(TAG, "Touch detected during screensaver, exiting");
-        screensaver_active = false;
-        bg_drawn = false;  // Reset for next time
-        last_loaded_frame = -1;
-        
-        // Close file
-        if (current_file != NULL) {
-            fclose(current_file);
-            current_file = NULL;
+    next_sd_frame(duration_ms);
+    return true;
+}
+
+// Compose one frame in RAM band by band (sprites in flash, rainbow and stars generated)
+static void draw_composed_frame(void) {
+    extern void ili9341_write_pixels(const uint16_t* pixels, uint32_t length);
+    
+    uint16_t* band = chunk_buffer;
+    for (int y = 0; y < NYAN_HEIGHT; y += CHUNK_LINES) {
+        nyan_compose_band(band, y, CHUNK_LINES, compose_frame);
+        ili9341_set_addr_window(0, y, NYAN_WIDTH - 1, y + CHUNK_LINES - 1);
+        ili9341_write_pixels(band, NYAN_WIDTH * CHUNK_LINES);
+        band = (band == chunk_buffer) ? chunk_buffer2 : chunk_buffer;
+    }
+    
+    compose_frame += frame_sched_wait(&frame_sched, nyan_compositor_frame_ms());
+}
+
+static void draw_nyan_screensaver(void) {
+    // Allocate compositor buffers once (40 lines each = 25,600 bytes)
+    if (chunk_buffer == NULL) {
+        chunk_bufs[0] = dma_buf_alloc(NYAN_WIDTH * CHUNK_LINES * 2, "compositor");
+        chunk_bufs[1] = dma_buf_alloc(NYAN_WIDTH * CHUNK_LINES * 2, "compositor");
+        if (chunk_bufs[0] == NULL || chunk_bufs[1] == NULL) {
+            ESP_LOGE(TAG, "Failed to allocate buffers (%d bytes each)", NYAN_WIDTH * CHUNK_LINES * 2);
+            dma_buf_unref(chunk_bufs[0]);
+            dma_buf_unref(chunk_bufs[1]);
+            chunk_bufs[0] = chunk_bufs[1] = NULL;
+            vTaskDelay(pdMS_TO_TICKS(100));
+            return;
         }
+        chunk_buffer = (uint16_t*)dma_buf_data(chunk_bufs[0]);
+        chunk_buffer2 = (uint16_t*)dma_buf_data(chunk_bufs[1]);
+        ESP_LOGI(TAG, "Allocated double buffers: %d bytes each for %d lines", NYAN_WIDTH * CHUNK_LINES * 2, CHUNK_LINES);
+    }
+    
+    // Pre-rendered SD frames when enabled, otherwise (or without a card) compose in RAM
+    if (!SCREENSAVER_USE_SD_FRAMES || !draw_sd_frame()) {
+        draw_composed_frame();
+    }
+}
+
+// Screensaver display task (core 1): owns SPI2 while the screensaver is active
+static void screensaver_task(void *arg) {
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);  // Started by screensaver_start()
         
-        // Free buffers when exiting screensaver to save RAM
-        if (chunk_buffer != NULL) {
-            free(chunk_buffer);
-            chunk_buffer = NULL;
-        }
-        if (chunk_buffer2 != NULL) {
-            free(chunk_buffer2);
-            chunk_buffer2 = NULL;
+        ili9341_fill_screen(ILI9341_BLACK);
+        nyan_compositor_init();
+        frame_sched_reset(&frame_sched);  // New playback timeline
+        
+        while (screensaver_active) {
+            draw_nyan_screensaver();
         }
         
-        lv_obj_invalidate(main_screen);  // Redraw UI
-        update_touch_time();  // Reset timer
+        // Stop the SD reader and free buffers when exiting screensaver to save RAM
+        stop_sd_frames();
+        frame_cache_deinit(&frame_cache);  // PSRAM frames are refilled next session
+        dma_buf_unref(chunk_bufs[0]);
+        dma_buf_unref(chunk_bufs[1]);
+        chunk_bufs[0] = chunk_bufs[1] = NULL;
+        chunk_buffer = NULL;
+        chunk_buffer2 = NULL;
+        frame_sched_log_stats(&frame_sched, "Screensaver");
+        
+        xSemaphoreGive(screensaver_done);
     }
 }
 
+static void screensaver_start(void) {
+    touch_service_set_idle(true);  // Slower touch scan until the screensaver exits
+    screensaver_active = true;
+    xTaskNotifyGive(screensaver_task_handle);
+}
+
 // Read cable ID from IC (placeholder - implement based on your IC interface)
 static uint8_t read_cable_id(void) {
     // TODO: Implement actual IC communication
@@ -251,12 +385,29 @@ static void roller_event_handler(lv_event_t * e)
     if(code == LV_EVENT_VALUE_CHANGED) {
         uint32_t selected = lv_roller_get_selected(obj);
         ESP_LOGI(TAG, "Selected cable: %s", cable_configs[selected].name);
+        sd_logger_printf("select,%s", cable_configs[selected].name);
         
         // Update top bar label with selected cable name
         lv_label_set_text(label_selected, cable_configs[selected].name);
     }
 }
 
+// Hardware swipes: left/right step the roller (vertical drags already scroll it)
+static void gesture_event_handler(lv_event_t * e)
+{
+    lvgl_port_gesture_t gesture = *(lvgl_port_gesture_t*)lv_event_get_param(e);
+    if (gesture != LVGL_PORT_GESTURE_SWIPE_LEFT && gesture != LVGL_PORT_GESTURE_SWIPE_RIGHT) {
+        ESP_LOGD(TAG, "Gesture %d ignored", gesture);
+        return;
+    }
+    
+    uint32_t count = lv_roller_get_option_count(roller_cables);
+    uint32_t selected = lv_roller_get_selected(roller_cables);
+    selected = (gesture == LVGL_PORT_GESTURE_SWIPE_LEFT) ? (selected + 1) % count : (selected + count - 1) % count;
+    lv_roller_set_selected(roller_cables, selected, LV_ANIM_OFF);
+    lv_obj_send_event(roller_cables, LV_EVENT_VALUE_CHANGED, NULL);
+}
+
 // Apply color profile to UI
 static void apply_color_profile(int profile) {
     // Define 5 color profiles
@@ -379,6 +530,7 @@ static void create_ui(void)
     
     // Add event handler
     lv_obj_add_event_cb(roller_cables, roller_event_handler, LV_EVENT_VALUE_CHANGED, NULL);
+    lv_obj_add_event_cb(main_screen, gesture_event_handler, (lv_event_code_t)lvgl_port_gesture_event(), NULL);
     
     ESP_LOGI(TAG, "LVGL UI created");
 }
@@ -397,9 +549,52 @@ static void update_detected_cable(uint8_t cable_id)
     }
 }
 
-// Embedded boot splash data (generated from boot_splash.raw)
-extern const uint8_t boot_splash_data[];
-extern const uint32_t boot_splash_data_size;
+// Embedded boot splash (src/boot_splash.bin, packed by embed_boot_splash.py):
+// a compressed NYF1 asset or a baseline JPEG
+extern const uint8_t boot_splash_start[] asm("_binary_boot_splash_bin_start");
+extern const uint8_t boot_splash_end[] asm("_binary_boot_splash_bin_end");
+
+// JPEG output: one MCU row per band (16 lines covers 4:2:0 and 4:4:4)
+#define JPEG_BAND_LINES 16
+
+typedef struct {
+    uint16_t x;
+    uint16_t y;
+} jpeg_origin_t;
+
+// Send each decoded JPEG band to the panel as one window
+static uint16_t* panel_jpeg_flush(void* ctx, const frame_jpeg_t* jpeg, uint16_t y, uint16_t lines, uint16_t* pixels) {
+    extern void ili9341_write_pixels(const uint16_t* pixels, uint32_t length);
+    const jpeg_origin_t* origin = (const jpeg_origin_t*)ctx;
+    
+    ili9341_set_addr_window(origin->x, origin->y + y,
+                            origin->x + jpeg->width - 1, origin->y + y + lines - 1);
+    ili9341_write_pixels(pixels, (uint32_t)jpeg->width * lines);
+    return pixels;
+}
+
+// Decode a baseline JPEG held in memory (e.g. flash) to the panel at (x, y)
+static bool draw_jpeg(const uint8_t* data, uint32_t size, uint16_t x, uint16_t y) {
+    static frame_jpeg_t jpeg;  // ~3 KB decoder work area, kept off the stack
+    
+    if (!frame_jpeg_open_mem(&jpeg, data, size)) {
+        return false;
+    }
+    
+    dma_buf_t* band_buf = dma_buf_alloc(jpeg.width * JPEG_BAND_LINES * sizeof(uint16_t), "jpeg_band");
+    if (band_buf == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate JPEG band buffer");
+        frame_jpeg_close(&jpeg);
+        return false;
+    }
+    
+    jpeg_origin_t origin = { .x = x, .y = y };
+    bool ok = frame_jpeg_decode(&jpeg, (uint16_t*)dma_buf_data(band_buf), JPEG_BAND_LINES, panel_jpeg_flush, &origin);
+    
+    dma_buf_unref(band_buf);
+    frame_jpeg_close(&jpeg);
+    return ok;
+}
 
 // Display boot screen with HPTuners logo
 static void show_boot_screen(void) {
@@ -409,130 +604,337 @@ static void show_boot_screen(void) {
     extern void ili9341_set_backlight(uint8_t brightness);
     ili9341_set_backlight(0);
     
-    // Display boot splash from embedded data (no SD card needed)
+    // Display boot splash from flash (no SD card needed): the asset partition
+    // copy if one was flashed, otherwise the copy embedded in the firmware
     #define SPLASH_WIDTH 320
     #define SPLASH_HEIGHT 240
-    #define SPLASH_CHUNK_LINES 40  // Display 40 lines at a time
-    
-    ESP_LOGI(TAG, "Displaying embedded boot splash (%d bytes)...", boot_splash_data_size);
+    #define SPLASH_CHUNK_LINES 40  // Display 40 lines at a time (the asset's band height)
+    
+    const uint8_t* splash = boot_splash_start;
+    uint32_t splash_size = boot_splash_end - boot_splash_start;
+    asset_t splash_asset;
+    if (asset_pack_init() && asset_pack_find("boot_splash", &splash_asset)) {
+        splash = splash_asset.data;
+        splash_size = splash_asset.size;
+        ESP_LOGI(TAG, "Displaying boot splash from asset pack (%lu bytes)...", (unsigned long)splash_size);
+    } else {
+        ESP_LOGI(TAG, "Displaying embedded boot splash (%lu bytes)...", (unsigned long)splash_size);
+    }
     
-    // Display in chunks for consistency with screensaver method
-    for (int y = 0; y < SPLASH_HEIGHT; y += SPLASH_CHUNK_LINES) {
-        uint32_t offset = y * SPLASH_WIDTH * 2;  // Byte offset
-        const uint16_t* chunk_ptr = (const uint16_t*)(boot_splash_data + offset);
-        
-        ili9341_set_addr_window(0, y, SPLASH_WIDTH - 1, y + SPLASH_CHUNK_LINES - 1);
+    if (frame_jpeg_is_jpeg(splash, splash_size)) {
+        // Baseline JPEG splash, decoded by the ROM TJpgDec
+        if (!draw_jpeg(splash, splash_size, 0, 0)) {
+            ESP_LOGE(TAG, "Failed to decode JPEG boot splash");
+        }
+    } else if (splash_size == SPLASH_WIDTH * SPLASH_HEIGHT * sizeof(uint16_t)) {
+        // Legacy raw RGB565 splash, sent from mapped flash through the staging buffers
         extern void ili9341_write_pixels(const uint16_t* pixels, uint32_t length);
-        ili9341_write_pixels(chunk_ptr, SPLASH_WIDTH * SPLASH_CHUNK_LINES);
+        ili9341_set_addr_window(0, 0, SPLASH_WIDTH - 1, SPLASH_HEIGHT - 1);
+        ili9341_write_pixels((const uint16_t*)splash, SPLASH_WIDTH * SPLASH_HEIGHT);
+    } else {
+        // Compressed NYF1 splash, decoded band by band into a DMA buffer
+        static frame_stream_t stream;  // Palette/LUT/input ring, kept off the stack
+        dma_buf_t* band_buf = NULL;
+        
+        if (!frame_stream_open_mem(&stream, splash, splash_size) ||
+            stream.header.width != SPLASH_WIDTH || stream.header.height != SPLASH_HEIGHT) {
+            ESP_LOGE(TAG, "Invalid boot splash asset");
+        } else if ((band_buf = dma_buf_alloc(SPLASH_WIDTH * SPLASH_CHUNK_LINES * sizeof(uint16_t), "splash_band")) == NULL) {
+            ESP_LOGE(TAG, "Failed to allocate boot splash band buffer");
+        } else {
+            extern void ili9341_write_pixels(const uint16_t* pixels, uint32_t length);
+            uint16_t* band = (uint16_t*)dma_buf_data(band_buf);
+            
+            for (int y = 0; y < SPLASH_HEIGHT; y += SPLASH_CHUNK_LINES) {
+                if (!frame_stream_read_lines(&stream, band, SPLASH_CHUNK_LINES)) {
+                    ESP_LOGE(TAG, "Boot splash decode failed at line %d", y);
+                    break;
+                }
+                ili9341_set_addr_window(0, y, SPLASH_WIDTH - 1, y + SPLASH_CHUNK_LINES - 1);
+                ili9341_write_pixels(band, SPLASH_WIDTH * SPLASH_CHUNK_LINES);
+            }
+        }
+        
+        if (band_buf) {
+            dma_buf_unref(band_buf);
+        }
+        frame_stream_close(&stream);
     }
     
     ESP_LOGI(TAG, "Boot splash displayed successfully");
     
     // Turn on backlight now that image is displayed
     ili9341_set_backlight(255);
-    
+}
+
+// Hold the splash until the user touches the screen
+static void wait_for_start_touch(void) {
     ESP_LOGI(TAG, "Waiting for touch to start...");
     
-    // Clear any pending touches
-    vTaskDelay(pdMS_TO_TICKS(100));
-    
-    // Wait for touch before continuing
-    bool touched = false;
-    int check_count = 0;
-    while (!touched) {
-        if (ft6236_is_touched()) {
-            touched = true;
-            ESP_LOGI(TAG, "Touch detected after %d checks - starting application", check_count);
+    // Wait for a new touch sample (anything published before now is ignored)
+    uint32_t cursor = touch_service_seq();
+    touch_sample_t sample;
+    int waited_s = 0;
+    for (;;) {
+        if (touch_service_next(&cursor, &sample)) {
+            if (sample.touch_count > 0) {
+                break;
+            }
+            continue;
         }
-        check_count++;
-        if (check_count % 20 == 0) {
-            ESP_LOGI(TAG, "Still waiting for touch... (%d checks)", check_count);
+        if (!touch_service_wait(cursor, pdMS_TO_TICKS(1000))) {
+            ESP_LOGI(TAG, "Still waiting for touch... (%d s)", ++waited_s);
         }
-        vTaskDelay(pdMS_TO_TICKS(50));  // Poll every 50ms
     }
+    ESP_LOGI(TAG, "Touch detected - starting application");
     
     // Brief delay to debounce
     vTaskDelay(pdMS_TO_TICKS(200));
     ESP_LOGI(TAG, "=== BOOT SCREEN END ===");
 }
 
-// Simple gradient background demo
-void app_main(void) {
-    // Wait 3 seconds for serial monitor to connect
-    vTaskDelay(pdMS_TO_TICKS(3000));
-    
-    ESP_LOGI(TAG, "");
-    ESP_LOGI(TAG, "========================================");
-    ESP_LOGI(TAG, "ESP32-S3 ILI9341 + FT6236 Touch Demo");
-    ESP_LOGI(TAG, "========================================");
-    ESP_LOGI(TAG, "");
-    
-    // Initialize display FIRST (this initializes SPI2_HOST bus)
-    ili9341_config_t display_config = {
-        .pin_mosi = TFT_MOSI,
-        .pin_miso = TFT_MISO,
-        .pin_sclk = TFT_SCLK,
-        .pin_cs = TFT_CS,
-        .pin_dc = TFT_DC,
-        .pin_rst = TFT_RST,
-        .pin_bl = TFT_BL,
-        .spi_host = SPI2_HOST,
-        .spi_clock_mhz = 80  // 80MHz SPI clock - maximum speed
-    };
-    
+// Boot stages (run concurrently by boot_graph_run(), see app_main)
+static ili9341_config_t display_config = {
+    .pin_mosi = TFT_MOSI,
+    .pin_miso = TFT_MISO,
+    .pin_sclk = TFT_SCLK,
+    .pin_cs = TFT_CS,
+    .pin_dc = TFT_DC,
+    .pin_rst = TFT_RST,
+    .pin_bl = TFT_BL,
+    .spi_host = SPI2_HOST,
+    .spi_clock_mhz = 80  // 80MHz SPI clock - maximum speed
+};
+
+static sd_config_t sd_config = {
+    .backend = SD_USE_SDMMC ? SD_BACKEND_SDMMC : SD_BACKEND_SPI,
+    .pin_clk = SD_SCK,
+    .pin_cmd = SD_MOSI,
+    .pin_d0 = SD_MISO,
+    .pin_d3 = SD_CS,
+    .pin_d1 = SD_D1,
+    .pin_d2 = SD_D2,
+    .bus_width = SD_BUS_WIDTH,
+    .max_freq_khz = SD_FREQ_KHZ
+};
+
+static bool boot_display(void* ctx) {
+    (void)ctx;
+    // Display FIRST on its chain (this initializes SPI2_HOST bus)
     if (!ili9341_init(&display_config)) {
         ESP_LOGE(TAG, "Display initialization failed!");
-        return;
+        return false;
     }
-    
-    ESP_LOGI(TAG, "SD card initialized successfully");
-    
-    // Initialize SD card on SPI3
-    ESP_LOGI(TAG, "Initializing SD card on SPI3 (CS=%d, MOSI=%d, MISO=%d, CLK=%d)", 
-             SD_CS, SD_MOSI, SD_MISO, SD_SCK);
-    
-    // Try to initialize SD card, but don't block if it fails
-    if (!sd_init(SD_CS, SD_MOSI, SD_MISO, SD_SCK)) {
-        ESP_LOGW(TAG, "SD card initialization failed - will retry later");
-        ESP_LOGW(TAG, "Boot screen and screensaver may not work until SD card is ready");
-    } else {
-        ESP_LOGI(TAG, "SD card initialized successfully");
+    return true;
+}
+
+static bool boot_splash(void* ctx) {
+    (void)ctx;
+    show_boot_screen();
+    return true;
+}
+
+static bool boot_storage(void* ctx) {
+    (void)ctx;
+    ESP_LOGI(TAG, "Initializing SD card on %s (CS/D3=%d, MOSI/CMD=%d, MISO/D0=%d, CLK=%d)", 
+             SD_USE_SDMMC ? "SDMMC" : "SPI3", SD_CS, SD_MOSI, SD_MISO, SD_SCK);
+    
+    // Mount in the background (retries and hot-plug) so boot never waits on the card
+    if (!sd_service_start(&sd_config)) {
+        ESP_LOGE(TAG, "Failed to start SD mount service");
+        return false;
     }
     
-    // Initialize touch controller BEFORE boot screen
+    // Test results go to SD through a RAM ring; the UI loop never waits on the card
+    sd_logger_config_t logger_config = {
+        .dir = "/sdcard/logs",
+        .file_size = 1024 * 1024,
+        .max_files = 4,
+        .ring_size = 16 * 1024,
+        .sync_interval_ms = 2000,
+        .task_priority = 1
+    };
+    if (!sd_logger_start(&logger_config)) {
+        ESP_LOGE(TAG, "Failed to start result logger");
+    }
+    return true;
+}
+
+static bool boot_touch(void* ctx) {
+    (void)ctx;
     ft6236_config_t touch_config = {
         .i2c_port = I2C_NUM_0,
         .pin_sda = TOUCH_SDA,
         .pin_scl = TOUCH_SCL,
         .pin_int = TOUCH_INT,
-        .i2c_freq = 400000  // 400kHz I2C
+        .i2c_freq = TOUCH_I2C_FREQ
     };
     
     if (!ft6236_init(&touch_config)) {
         ESP_LOGE(TAG, "Touch controller initialization failed!");
-    } else {
-        ESP_LOGI(TAG, "Touch controller initialized successfully");
+        return false;
     }
-    
-    // Show boot screen with HPTuners logo
-    ESP_LOGI(TAG, "*** ABOUT TO CALL show_boot_screen() ***");
-    show_boot_screen();
-    ESP_LOGI(TAG, "*** show_boot_screen() RETURNED ***");
-    
-    // Initialize touch time BEFORE LVGL to prevent screensaver triggering immediately
-    last_touch_time = esp_timer_get_time() / 1000;
-    last_profile_change = last_touch_time;  // Initialize profile timer
-    
-    // Initialize LVGL
+    ESP_LOGI(TAG, "Touch controller initialized successfully");
+    return touch_service_start(TOUCH_INT, TOUCH_CORE);
+}
+
+static bool boot_ui(void* ctx) {
+    (void)ctx;
+    // LVGL only draws from the main loop, so it can be set up while the splash shows
     ESP_LOGI(TAG, "Initializing LVGL...");
     if (!lvgl_port_init()) {
         ESP_LOGE(TAG, "LVGL initialization failed!");
-        return;
+        return false;
     }
     
-    // Create UI
     ESP_LOGI(TAG, "Creating UI...");
     create_ui();
+    return true;
+}
+
+enum { BOOT_DISPLAY, BOOT_SPLASH, BOOT_STORAGE, BOOT_TOUCH, BOOT_UI, BOOT_STAGES };
+
+static const boot_stage_t boot_stages[BOOT_STAGES] = {
+    [BOOT_DISPLAY] = { .name = "display", .fn = boot_display },
+    [BOOT_SPLASH]  = { .name = "splash",  .fn = boot_splash, .deps = BOOT_DEP(BOOT_DISPLAY) },
+    [BOOT_STORAGE] = { .name = "storage", .fn = boot_storage },
+    [BOOT_TOUCH]   = { .name = "touch",   .fn = boot_touch },
+    [BOOT_UI]      = { .name = "ui",      .fn = boot_ui, .stack_size = 8192 },
+};
+
+// Main loop jobs, all run on the app_main task (which owns LVGL)
+static app_job_t* lvgl_job;
+static app_job_t* idle_job;
+static app_job_t* touch_job;
+
+// LVGL timers, input and rendering; re-armed for LVGL's next due timer
+static void lvgl_job_fn(void* ctx) {
+    (void)ctx;
+    if (screensaver_active) {
+        return;  // The screensaver task owns SPI2; restarted by touch_job_fn on exit
+    }
+    uint32_t next_ms = lvgl_port_task_handler();
+    if (next_ms == 0) {
+        next_ms = 1;
+    } else if (next_ms > LVGL_MAX_SLEEP_MS) {
+        next_ms = LVGL_MAX_SLEEP_MS;  // Also covers LV_NO_TIMER_READY
+    }
+    app_sched_start_once(lvgl_job, next_ms);
+}
+
+// New touch sample (touch task context). LVGL polls the touch service on its
+// own indev timer, so the loop only needs waking while the screensaver runs.
+static void touch_sample_cb(const touch_sample_t* sample, void* ctx) {
+    (void)sample;
+    (void)ctx;
+    if (screensaver_active) {
+        app_sched_trigger(touch_job);
+    }
+}
+
+static void touch_job_fn(void* ctx) {
+    (void)ctx;
+    if (screensaver_active && touch_service_last_touch_us() / 1000 > last_touch_time) {
+        update_touch_time();  // Exits the screensaver
+        app_sched_start_once(idle_job, SCREENSAVER_TIMEOUT_MS);
+        app_sched_trigger(lvgl_job);  // Redraw the UI right away
+    }
+}
+
+// Screensaver timeout: fires when the last known touch would expire and
+// re-arms itself if a touch arrived in the meantime
+static void idle_job_fn(void* ctx) {
+    (void)ctx;
+    if (screensaver_active) {
+        return;  // Re-armed when the screensaver exits
+    }
+    int64_t idle_time = esp_timer_get_time() / 1000 - last_touch_time;
+    if (idle_time < SCREENSAVER_TIMEOUT_MS) {
+        app_sched_start_once(idle_job, (uint32_t)(SCREENSAVER_TIMEOUT_MS - idle_time));
+        return;
+    }
+    ESP_LOGI(TAG, "*** SCREENSAVER ACTIVATED after %lld ms idle ***", idle_time);
+    touch_latency_report();  // Touch-to-photon percentiles for the session so far
+    screensaver_start();  // Display task blacks out the screen and animates
+}
+
+// Periodically check for cable ID changes
+static void cable_job_fn(void* ctx) {
+    (void)ctx;
+    uint8_t new_id = read_cable_id();
+    if (new_id != detected_cable_id) {
+        detected_cable_id = new_id;
+        update_detected_cable(detected_cable_id);
+        ESP_LOGI(TAG, "Cable ID changed: 0x%02X", detected_cable_id);
+        sd_logger_printf("detect,0x%02X", detected_cable_id);
+    }
+}
+
+// Change UI color profile (when not in screensaver)
+static void profile_job_fn(void* ctx) {
+    (void)ctx;
+    if (!screensaver_active) {
+        ui_color_profile = (ui_color_profile + 1) % 5;
+        apply_color_profile(ui_color_profile);
+        app_sched_trigger(lvgl_job);
+    }
+}
+
+// Debug: log idle time (and the scheduler's own stats now and then)
+static void telemetry_job_fn(void* ctx) {
+    (void)ctx;
+    static uint32_t runs = 0;
+    int64_t idle_time = esp_timer_get_time() / 1000 - last_touch_time;
+    ESP_LOGI(TAG, "Idle: %lld ms, Active: %d, Timeout: %d ms", 
+             idle_time, screensaver_active, SCREENSAVER_TIMEOUT_MS);
+    if (++runs % TELEMETRY_STATS_EVERY == 0) {
+        app_sched_log_stats();
+    }
+}
+
+void app_main(void) {
+    boot_timeline_mark("app_main");
+#if BOOT_SERIAL_DELAY_MS > 0
+    // Give a late-attaching serial monitor time to connect
+    vTaskDelay(pdMS_TO_TICKS(BOOT_SERIAL_DELAY_MS));
+#endif
+    
+    ESP_LOGI(TAG, "");
+    ESP_LOGI(TAG, "========================================");
+    ESP_LOGI(TAG, "ESP32-S3 ILI9341 + FT6236 Touch Demo");
+    ESP_LOGI(TAG, "========================================");
+    ESP_LOGI(TAG, "");
+    
+#ifdef SD_BENCH
+    // Benchmark build (pio run -e sd-bench): measure the card instead of running the UI
+    sd_bench_app(&sd_config);
+    return;
+#endif
+    
+    // Display -> splash is the critical path; storage, touch and LVGL run beside it
+    bool stage_ok[BOOT_STAGES];
+    boot_graph_run(boot_stages, BOOT_STAGES, stage_ok);
+    boot_timeline_mark("boot_done");
+    ESP_LOGI(TAG, "Splash visible %lld ms after startup",
+             (long long)(boot_timeline_end_us("splash") / 1000));
+    boot_timeline_print();
+    if (!stage_ok[BOOT_DISPLAY] || !stage_ok[BOOT_UI]) {
+        return;
+    }
+    
+    wait_for_start_touch();
+    
+    // Initialize touch time BEFORE the main loop to prevent screensaver triggering immediately
+    last_touch_time = esp_timer_get_time() / 1000;
+    
+    // Screensaver display task on core 1 (SD reader runs on core 0)
+    screensaver_done = xSemaphoreCreateBinary();
+    if (screensaver_done == NULL ||
+        xTaskCreatePinnedToCore(screensaver_task, "screensaver", 4096, NULL, 4,
+                                &screensaver_task_handle, SCREENSAVER_CORE) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create screensaver task!");
+        return;
+    }
     
     // Read initial cable ID
     detected_cable_id = read_cable_id();
@@ -541,69 +943,28 @@ void app_main(void) {
     ESP_LOGI(TAG, "System ready! Use roller to select cable type.");
     ESP_LOGI(TAG, "Screensaver will activate after %d ms of inactivity", SCREENSAVER_TIMEOUT_MS);
     
-    // Main loop with LVGL task handler
-    uint32_t last_id_check = 0;
+    // Main loop: every periodic check is a job with its own timer, so the
+    // loop blocks until one is due, a touch arrives or LVGL needs to run
+    if (!app_sched_init()) {
+        ESP_LOGE(TAG, "Failed to create the app scheduler!");
+        return;
+    }
+    lvgl_job = app_sched_add("lvgl", lvgl_job_fn, NULL, 0);
+    idle_job = app_sched_add("idle", idle_job_fn, NULL, 0);
+    touch_job = app_sched_add("touch", touch_job_fn, NULL, 0);
+    app_sched_add("cable", cable_job_fn, NULL, CABLE_POLL_MS);
+    app_sched_add("profile", profile_job_fn, NULL, PROFILE_CYCLE_MS);
+    app_sched_add("telemetry", telemetry_job_fn, NULL, TELEMETRY_MS);
+    if (lvgl_job == NULL || idle_job == NULL || touch_job == NULL) {
+        ESP_LOGE(TAG, "Failed to register main loop jobs!");
+        return;
+    }
+    
+    touch_service_set_callback(touch_sample_cb, NULL);
+    app_sched_start_once(idle_job, SCREENSAVER_TIMEOUT_MS);
+    app_sched_trigger(lvgl_job);
     
     while (1) {
-        // Change UI color profile every 5 seconds (when not in screensaver)
-        if (!screensaver_active) {
-            int64_t current_time = esp_timer_get_time() / 1000;
-            if (current_time - last_profile_change > 5000) {
-                ui_color_profile = (ui_color_profile + 1) % 5;
-                last_profile_change = current_time;
-                apply_color_profile(ui_color_profile);
-            }
-        }
-        
-        // Periodically check for cable ID changes
-        uint32_t now = xTaskGetTickCount() / portTICK_PERIOD_MS;
-        if (now - last_id_check > 1000) {  // Check every second
-            uint8_t new_id = read_cable_id();
-            if (new_id != detected_cable_id) {
-                detected_cable_id = new_id;
-                update_detected_cable(detected_cable_id);
-                ESP_LOGI(TAG, "Cable ID changed: 0x%02X", detected_cable_id);
-            }
-            last_id_check = now;
-        }
-        
-        // Check for screensaver timeout
-        int64_t current_time = esp_timer_get_time() / 1000;
-        int64_t idle_time = current_time - last_touch_time;
-        
-        // Debug: Log idle time every 5 seconds
-        static int64_t last_debug_time = 0;
-        if (current_time - last_debug_time > 5000) {
-            ESP_LOGI(TAG, "Idle: %lld ms, Active: %d, Timeout: %d ms", 
-                     idle_time, screensaver_active, SCREENSAVER_TIMEOUT_MS);
-            last_debug_time = current_time;
-        }
-        
-        if (!screensaver_active && idle_time > SCREENSAVER_TIMEOUT_MS) {
-            screensaver_active = true;
-            ESP_LOGI(TAG, "*** SCREENSAVER ACTIVATED after %lld ms idle ***", idle_time);
-            // Black out screen for screensaver
-            ili9341_fill_screen(ILI9341_BLACK);
-        }
-        
-        // Draw screensaver if active
-        if (screensaver_active) {
-            // Check for touch to exit screensaver
-            ft6236_touch_t touch_data;
-            if (ft6236_read_touch(&touch_data) && touch_data.touch_count > 0) {
-                update_touch_time();  // This will exit screensaver
-                // Give LVGL one cycle to redraw the UI
-                if (!screensaver_active) {
-                    lvgl_port_task_handler();
-                }
-            } else {
-                draw_nyan_screensaver();
-            }
-            // No delay - maximum frame rate for screensaver
-        } else {
-            // Handle LVGL tasks (touch input, rendering, etc.)
-            lvgl_port_task_handler();
-            // No delay - maximum responsiveness
-        }
+        app_sched_run(portMAX_DELAY);
     }
 }
@@ -0,0 +1,201 @@
+/*
+ * Host benchmark: frame decode throughput vs. SD card read throughput
+ *
+ * Decodes NYF1 frame assets (see lib/FRAME/frame_format.h) band by band
+ * through the same frame_stream code the firmware uses, and compares the
+ * time spent decoding with the time the SD card needs to deliver the stored
+ * bytes. A codec pays off when (stored bytes / SD rate) + decode time is
+ * below the time to read the uncompressed RGB565 frame.
+ *
+ * Build (from the repository root):
+ *   gcc -O2 -Itools/host -Ilib/FRAME tools/bench/frame_codec_bench.c \
+ *       lib/FRAME/frame_stream.c lib/FRAME/frame_codec.c lib/FRAME/frame_decode.c \
+ *       -o frame_codec_bench
+ *
+ * Usage:
+ *   ./frame_codec_bench [--sd-mbps 1.9] [--cpu-scale 10] data/nyan_*.raw
+ *
+ *   --sd-mbps    Sustained SD read rate in MB/s (default 1.9, 20 MHz SDSPI)
+ *   --cpu-scale  Host/ESP32-S3 speed ratio applied to decode times (default 1)
+ *
+ * Output is one CSV line per asset plus a totals line.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "frame_stream.h"
+
+#define BAND_LINES   40
+#define MIN_RUN_NS   200000000LL  // Repeat each asset for at least 200 ms
+
+static const char *codec_name(uint8_t codec) {
+    switch (codec) {
+        case FRAME_CODEC_RLE: return "rle";
+        case FRAME_CODEC_LZ4: return "lz4";
+        default:              return "none";
+    }
+}
+
+static const char *format_name(uint8_t format) {
+    switch (format) {
+        case FRAME_FMT_INDEX8: return "index8";
+        case FRAME_FMT_INDEX4: return "index4";
+        default:               return "rgb565";
+    }
+}
+
+static long long now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static uint8_t *load_file(const char *path, uint32_t *size) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *data = malloc(len);
+    if (data && fread(data, 1, len, f) != (size_t)len) {
+        free(data);
+        data = NULL;
+    }
+    fclose(f);
+    *size = (uint32_t)len;
+    return data;
+}
+
+// Lines per decode call: the asset's band height (compressed bands are independent blocks)
+static uint16_t band_lines(const frame_stream_t *stream) {
+    return stream->header.band_lines ? stream->header.band_lines : BAND_LINES;
+}
+
+// Decode one full frame; returns false on error
+static bool decode_frame(frame_stream_t *stream, uint16_t *band) {
+    uint16_t step = band_lines(stream);
+    if (!frame_stream_rewind(stream)) return false;
+    for (uint16_t y = 0; y < stream->header.height; y += step) {
+        uint16_t lines = stream->header.height - y;
+        if (lines > step) lines = step;
+        if (!frame_stream_read_lines(stream, band, lines)) return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    double sd_mbps = 1.9;
+    double cpu_scale = 1.0;
+    int first = 1;
+
+    while (first < argc && strncmp(argv[first], "--", 2) == 0) {
+        if (strcmp(argv[first], "--sd-mbps") == 0 && first + 1 < argc) {
+            sd_mbps = atof(argv[first + 1]);
+        } else if (strcmp(argv[first], "--cpu-scale") == 0 && first + 1 < argc) {
+            cpu_scale = atof(argv[first + 1]);
+        } else {
+            fprintf(stderr, "Unknown option %s\n", argv[first]);
+            return 2;
+        }
+        first += 2;
+    }
+    if (first >= argc) {
+        fprintf(stderr, "Usage: %s [--sd-mbps N] [--cpu-scale N] asset...\n", argv[0]);
+        return 2;
+    }
+
+    static frame_stream_t stream;
+    uint16_t *band = NULL;
+    size_t band_pixels = 0;
+    int failures = 0;
+    double sd_bytes_per_ms = sd_mbps * 1000.0;  // 1 MB/s = 1000 bytes/ms
+
+    double total_stored = 0, total_raw = 0, total_decode_ms = 0;
+
+    printf("asset,format,codec,stored_bytes,raw_bytes,ratio,decode_mbps,"
+           "decode_ms,sd_ms,frame_ms,raw_sd_ms,speedup\n");
+
+    for (int i = first; i < argc; i++) {
+        uint32_t size = 0;
+        uint8_t *data = load_file(argv[i], &size);
+        if (!data || !frame_stream_open_mem(&stream, data, size)) {
+            fprintf(stderr, "Skipping %s\n", argv[i]);
+            free(data);
+            continue;
+        }
+
+        // Band buffer sized from this asset's header
+        size_t pixels = (size_t)stream.header.width * band_lines(&stream);
+        if (pixels > band_pixels) {
+            uint16_t *grown = realloc(band, pixels * sizeof(uint16_t));
+            if (!grown) {
+                fprintf(stderr, "Out of memory for %s\n", argv[i]);
+                return 1;
+            }
+            band = grown;
+            band_pixels = pixels;
+        }
+
+        // Warm up and measure stored bytes actually consumed per frame
+        if (!decode_frame(&stream, band)) {
+            fprintf(stderr, "Decode failed: %s\n", argv[i]);
+            failures++;
+            frame_stream_close(&stream);
+            free(data);
+            continue;
+        }
+        double stored = size;
+        double raw = (double)stream.header.width * stream.header.height * 2;
+
+        long long start = now_ns();
+        long long elapsed;
+        int iterations = 0;
+        bool decoded = true;
+        do {
+            decoded = decode_frame(&stream, band);
+            iterations++;
+            elapsed = now_ns() - start;
+        } while (decoded && elapsed < MIN_RUN_NS);
+
+        // A failed decode stops early and would be reported as a fast one
+        if (!decoded) {
+            fprintf(stderr, "Decode failed: %s (iteration %d)\n", argv[i], iterations);
+            failures++;
+            frame_stream_close(&stream);
+            free(data);
+            continue;
+        }
+
+        double decode_ms = (elapsed / 1e6) / iterations * cpu_scale;
+        double decode_mbps = raw / 1e6 / (decode_ms / 1000.0);
+        double sd_ms = stored / sd_bytes_per_ms;
+        double raw_sd_ms = raw / sd_bytes_per_ms;
+        double frame_ms = sd_ms + decode_ms;
+
+        printf("%s,%s,%s,%.0f,%.0f,%.2f,%.1f,%.3f,%.3f,%.3f,%.3f,%.2f\n",
+               argv[i], format_name(stream.header.format), codec_name(stream.header.codec),
+               stored, raw, raw / stored, decode_mbps, decode_ms, sd_ms, frame_ms,
+               raw_sd_ms, raw_sd_ms / frame_ms);
+
+        total_stored += stored;
+        total_raw += raw;
+        total_decode_ms += decode_ms;
+
+        frame_stream_close(&stream);
+        free(data);
+    }
+
+    if (total_raw > 0) {
+        double sd_ms = total_stored / sd_bytes_per_ms;
+        double raw_sd_ms = total_raw / sd_bytes_per_ms;
+        printf("TOTAL,,,%.0f,%.0f,%.2f,%.1f,%.3f,%.3f,%.3f,%.3f,%.2f\n",
+               total_stored, total_raw, total_raw / total_stored,
+               total_raw / 1e6 / (total_decode_ms / 1000.0), total_decode_ms,
+               sd_ms, sd_ms + total_decode_ms, raw_sd_ms, raw_sd_ms / (sd_ms + total_decode_ms));
+    }
+
+    free(band);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,214 @@
+/*
+ * Host runner for the SD throughput benchmark (lib/SDBENCH)
+ *
+ * Runs the same benchmark matrix as the sd-bench firmware environment over a
+ * file-backed mock card, so the harness and its CSV output can be checked
+ * and settings compared before going to the fixture. Reads come from a
+ * regular file; bus time is modelled on top of the measured host time:
+ *
+ *   command:  --cmd-us per SD command (CMD17/CMD18 + response)
+ *   transfer: 512 bytes * 8 / (clock * bus width) per sector
+ *   stdio:    --stdio-us per fread call (newlib + VFS + FATFS), and one
+ *             command per cluster (--cluster-kb) instead of one per read
+ *   misaligned buffers: one single-sector command per sector (the SD driver
+ *             bounces non-DMA-capable buffers sector by sector)
+ *
+ * Build (from the repository root):
+ *   gcc -O2 -Ilib/SDBENCH tools/bench/sd_bench_host.c lib/SDBENCH/sd_bench.c \
+ *       -o sd_bench_host
+ *
+ * Usage:
+ *   ./sd_bench_host [--clocks 20000,40000] [--width 1] [--cmd-us 60]
+ *                   [--stdio-us 40] [--cluster-kb 16] [--file sdbench.bin]
+ *
+ * The test file is created (4 MB) if missing. Output uses the firmware's
+ * "SDBENCH," CSV format; "card" is "mock".
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sd_bench.h"
+
+#define SECTOR         512
+#define FILE_SIZE      (4 * 1024 * 1024)
+#define MAX_CLOCKS     8
+
+typedef struct {
+    uint32_t clock_khz;
+    uint32_t width;
+    double cmd_us;
+    double stdio_us;
+    uint32_t cluster_bytes;
+} mock_model_t;
+
+static mock_model_t model = { 20000, 1, 60.0, 40.0, 16 * 1024 };
+static double modelled_us = 0;  // Bus time added to the host clock
+
+typedef struct {
+    FILE *file;
+    uint32_t size;
+    bool stdio;                 // Model the stdio/FATFS path instead of raw sectors
+} mock_file_t;
+
+static int64_t host_now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000 + (int64_t)modelled_us;
+}
+
+static double sector_us(void) {
+    return SECTOR * 8.0 * 1000.0 / ((double)model.clock_khz * model.width);
+}
+
+// Charge the bus time for reading [offset, offset + size) into buffer
+static void charge(const mock_file_t *m, uint32_t offset, const void *buffer, uint32_t size) {
+    uint32_t first = offset / SECTOR;
+    uint32_t last = (offset + size - 1) / SECTOR;
+    uint32_t sectors = last - first + 1;
+    uint32_t commands;
+
+    if (((uintptr_t)buffer & 3) != 0) {
+        commands = sectors;  // Bounced one sector at a time
+    } else if (m->stdio) {
+        // FATFS issues one multi-block read per cluster touched
+        commands = (offset + size - 1) / model.cluster_bytes - offset / model.cluster_bytes + 1;
+    } else {
+        commands = 1;
+        if (offset % SECTOR) commands++;                            // Partial head via bounce
+        if ((offset + size) % SECTOR && sectors > 1) commands++;    // Partial tail via bounce
+    }
+
+    modelled_us += commands * model.cmd_us + sectors * sector_us();
+    if (m->stdio) {
+        modelled_us += model.stdio_us;
+    }
+}
+
+static bool mock_open(void *ctx, const char *path, uint32_t *size) {
+    mock_file_t *m = ctx;
+    m->file = fopen(path, "rb");
+    if (m->file == NULL) {
+        return false;
+    }
+    fseek(m->file, 0, SEEK_END);
+    m->size = (uint32_t)ftell(m->file);
+    *size = m->size;
+    return true;
+}
+
+static uint32_t mock_read(void *ctx, uint32_t offset, void *buffer, uint32_t size) {
+    mock_file_t *m = ctx;
+    if (fseek(m->file, offset, SEEK_SET) != 0) {
+        return 0;
+    }
+    uint32_t got = (uint32_t)fread(buffer, 1, size, m->file);
+    if (got > 0) {
+        charge(m, offset, buffer, got);
+    }
+    return got;
+}
+
+static void mock_close(void *ctx) {
+    mock_file_t *m = ctx;
+    fclose(m->file);
+    m->file = NULL;
+}
+
+static bool prepare_file(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (f != NULL) {
+        fseek(f, 0, SEEK_END);
+        long len = ftell(f);
+        fclose(f);
+        if (len == FILE_SIZE) {
+            return true;
+        }
+    }
+
+    f = fopen(path, "wb");
+    if (f == NULL) {
+        return false;
+    }
+    for (uint32_t pos = 0; pos < FILE_SIZE; pos++) {
+        fputc((uint8_t)(pos * 31 >> 3), f);
+    }
+    fclose(f);
+    return true;
+}
+
+int main(int argc, char **argv) {
+    const char *path = "sdbench.bin";
+    uint32_t clocks[MAX_CLOCKS] = { 10000, 20000, 26000, 40000 };
+    int clock_count = 4;
+
+    for (int i = 1; i < argc; i += 2) {
+        if (i + 1 >= argc) {
+            fprintf(stderr, "Missing value for %s\n", argv[i]);
+            return 2;
+        }
+        if (strcmp(argv[i], "--clocks") == 0) {
+            clock_count = 0;
+            for (char *tok = strtok(argv[i + 1], ","); tok && clock_count < MAX_CLOCKS; tok = strtok(NULL, ",")) {
+                clocks[clock_count++] = (uint32_t)atoi(tok);
+            }
+        } else if (strcmp(argv[i], "--width") == 0) {
+            model.width = (uint32_t)atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--cmd-us") == 0) {
+            model.cmd_us = atof(argv[i + 1]);
+        } else if (strcmp(argv[i], "--stdio-us") == 0) {
+            model.stdio_us = atof(argv[i + 1]);
+        } else if (strcmp(argv[i], "--cluster-kb") == 0) {
+            model.cluster_bytes = (uint32_t)atoi(argv[i + 1]) * 1024;
+        } else if (strcmp(argv[i], "--file") == 0) {
+            path = argv[i + 1];
+        } else {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 2;
+        }
+    }
+    if (model.width == 0 || model.cluster_bytes == 0 || clock_count == 0) {
+        fprintf(stderr, "Invalid model parameters\n");
+        return 2;
+    }
+
+    if (!prepare_file(path)) {
+        fprintf(stderr, "Cannot create %s\n", path);
+        return 1;
+    }
+
+    sd_bench_params_t params = {
+        .card = "mock",
+        .chunk_sizes = { 512, 4096, 16384, 25600, 32768, 65536 },
+        .chunk_count = 6,
+        .seq_bytes = 1024 * 1024,
+        .random_reads = 64,
+        .now_us = host_now_us
+    };
+    uint8_t *buffer = aligned_alloc(4, 65536 + SD_BENCH_ALIGN_SLACK);
+    if (buffer == NULL) {
+        return 1;
+    }
+
+    static mock_file_t stdio_file = { .stdio = true };
+    static mock_file_t raw_file = { .stdio = false };
+    sd_bench_io_t paths[] = {
+        { "stdio", mock_open, mock_read, mock_close, &stdio_file },
+        { "raw", mock_open, mock_read, mock_close, &raw_file },
+    };
+
+    bool ok = true;
+    sd_bench_print_header();
+    for (int c = 0; c < clock_count; c++) {
+        model.clock_khz = clocks[c];
+        params.clock_khz = clocks[c];
+        for (int p = 0; p < 2; p++) {
+            ok &= sd_bench_run(&paths[p], path, &params, buffer);
+        }
+    }
+    printf("SDBENCH_DONE\n");
+
+    free(buffer);
+    return ok ? 0 : 1;
+}
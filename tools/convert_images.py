@@ -2,11 +2,20 @@
 """
 Convert GIF frames and background to RGB565 raw format for ESP32-S3 SD card
 Images will be scaled to fit 320x240 display in landscape mode
+
+--jpeg writes the background as a baseline JPEG (nyan_bg.jpg, decodable by
+the ROM TJpgDec) instead of a 153,600-byte raw image. The current firmware
+does not draw a background image; the composed screensaver paints its sky.
 """
 
 from PIL import Image
+import argparse
 import os
 import struct
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..'))
+from frame_asset import encode_jpeg, DEFAULT_JPEG_QUALITY
 
 def rgb888_to_rgb565(r, g, b):
     """Convert RGB888 to RGB565 format"""
@@ -43,7 +52,25 @@ def convert_image_to_rgb565(input_path, output_path, target_width, target_height
     print(f"  -> {output_path} ({file_size} bytes)")
     return file_size
 
+def convert_image_to_jpeg(input_path, output_path, target_width, target_height, quality):
+    """Convert image to baseline JPEG"""
+    print(f"Converting {input_path}...")
+
+    img = Image.open(input_path).convert('RGB')
+    img = img.resize((target_width, target_height), Image.Resampling.LANCZOS)
+    with open(output_path, 'wb') as f:
+        f.write(encode_jpeg(img, quality))
+
+    file_size = os.path.getsize(output_path)
+    print(f"  -> {output_path} ({file_size} bytes)")
+    return file_size
+
 def main():
+    parser = argparse.ArgumentParser(description="Convert screensaver images for the SD card")
+    parser.add_argument('--jpeg', action='store_true', help="write the background as baseline JPEG")
+    parser.add_argument('--quality', type=int, default=DEFAULT_JPEG_QUALITY, help="JPEG quality (default: 85)")
+    args = parser.parse_args()
+
     # Paths
     source_dir = "../src/ncat"
     output_dir = "../sd_card"
@@ -74,10 +101,13 @@ def main():
     
     # Convert background (full screen 320x240 landscape)
     bg_input = os.path.join(source_dir, "nyan_bg.jpg")
-    bg_output = os.path.join(output_dir, "nyan_bg.raw")
+    bg_output = os.path.join(output_dir, "nyan_bg.jpg" if args.jpeg else "nyan_bg.raw")
     
     if os.path.exists(bg_input):
-        size = convert_image_to_rgb565(bg_input, bg_output, 320, 240)
+        if args.jpeg:
+            size = convert_image_to_jpeg(bg_input, bg_output, 320, 240, args.quality)
+        else:
+            size = convert_image_to_rgb565(bg_input, bg_output, 320, 240)
         total_size += size
     else:
         print(f"Warning: {bg_input} not found!")